@@ -0,0 +1,272 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32)
+    #define NOMINMAX
+    #include <direct.h>
+    #include <process.h>
+    #include <sys/utime.h>
+    #include <windows.h>
+#else
+    #include <dirent.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+    #include <utime.h>
+#endif
+
+#include "asm_cache.h"
+
+// Temporary files this old were left behind by a writer that did not finish.
+static constexpr int64_t STALE_TEMP_AGE = 60 * 60;
+
+static bool endsWith(std::string const & str, std::string const & suffix)
+{
+    return str.size() >= suffix.size() && str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+static void writeUint32(std::ostream & out, uint32_t value)
+{
+    out.write(reinterpret_cast<char const *>(&value), 4);
+}
+
+static void writeString(std::ostream & out, std::string const & str)
+{
+    writeUint32(out, static_cast<uint32_t>(str.size()));
+    out.write(str.data(), str.size());
+}
+
+static bool readUint32(std::istream & in, uint32_t & value)
+{
+    return static_cast<bool>(in.read(reinterpret_cast<char *>(&value), 4));
+}
+
+static bool readString(std::istream & in, std::string & str)
+{
+    uint32_t len;
+    if(! readUint32(in, len)) { return false; }
+    str.resize(len);
+    return len == 0 || static_cast<bool>(in.read(&str[0], len));
+}
+
+lc3::core::AssemblyCache::AssemblyCache(std::string const & directory, uint64_t max_size) :
+    directory(directory), max_size(max_size)
+{
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32)
+    _mkdir(directory.c_str());
+#else
+    mkdir(directory.c_str(), 0755);
+#endif
+}
+
+lc3::optional<lc3::core::SymbolTable> lc3::core::AssemblyCache::lookup(std::string const & source,
+    bool enable_liberal_asm, lc3::core::IObjectSink & sink)
+{
+    std::string key = getKey(source, enable_liberal_asm);
+    std::string name = getEntryName(key);
+    std::ifstream file(getPath(name), std::ios_base::binary);
+    if(! file) {
+        return {};
+    }
+
+    // The entry holds the entire key, so a hash collision is treated as a miss.
+    std::string entry_key;
+    if(! readString(file, entry_key) || entry_key != key) {
+        return {};
+    }
+
+    SymbolTable symbols;
+    uint32_t num_symbols;
+    if(! readUint32(file, num_symbols)) {
+        return {};
+    }
+    for(uint32_t i = 0; i < num_symbols; i += 1) {
+        std::string symbol;
+        uint32_t address;
+        if(! readString(file, symbol) || ! readUint32(file, address)) {
+            return {};
+        }
+        symbols[symbol] = address;
+    }
+
+    // Read the entire object before writing anything to the sink so that a damaged entry is just a miss.
+    ObjectMemorySink obj;
+    uint32_t num_entries;
+    if(! readUint32(file, num_entries)) {
+        return {};
+    }
+    obj.begin();
+    for(uint32_t i = 0; i < num_entries; i += 1) {
+        MemLocation entry;
+        file >> entry;
+        if(! file) {
+            return {};
+        }
+        obj.write(entry);
+    }
+    obj.end();
+
+    touch(name);
+    obj.replay(sink);
+
+    return symbols;
+}
+
+void lc3::core::AssemblyCache::store(std::string const & source, bool enable_liberal_asm,
+    lc3::core::ObjectMemorySink const & obj, lc3::core::SymbolTable const & symbols)
+{
+    std::string key = getKey(source, enable_liberal_asm);
+    std::string name = getEntryName(key);
+    std::string path = getPath(name);
+    std::string tmp_path = getTempPath(name);
+
+    {
+        std::ofstream file(tmp_path, std::ios_base::binary);
+        if(! file) {
+            return;
+        }
+
+        writeString(file, key);
+        writeUint32(file, static_cast<uint32_t>(symbols.size()));
+        for(auto const & symbol : symbols) {
+            writeString(file, symbol.first);
+            writeUint32(file, symbol.second);
+        }
+        writeUint32(file, static_cast<uint32_t>(obj.getEntries().size()));
+        for(MemLocation const & entry : obj.getEntries()) {
+            file << entry;
+        }
+
+        file.flush();
+        if(! file) {
+            file.close();
+            std::remove(tmp_path.c_str());
+            return;
+        }
+    }
+
+    // Replace the entry in one step so that other processes never see a partially written entry. Windows does not
+    // rename over an existing file, in which case the old entry is removed first.
+    if(std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        std::remove(path.c_str());
+        if(std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+            std::remove(tmp_path.c_str());
+            return;
+        }
+    }
+
+    evict(name);
+}
+
+std::string lc3::core::AssemblyCache::getKey(std::string const & source, bool enable_liberal_asm) const
+{
+    std::string key = lc3::utils::getAssemblerVersion();
+    key += '\0';
+    key += lc3::utils::getVersionString();
+    key += enable_liberal_asm ? '1' : '0';
+    key += '\0';
+    key += source;
+    return key;
+}
+
+std::string lc3::core::AssemblyCache::getEntryName(std::string const & key) const
+{
+    // 64-bit FNV-1a.
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for(char c : key) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 0x100000001b3ull;
+    }
+    return lc3::utils::ssprintf("%016llx.cache", static_cast<unsigned long long>(hash));
+}
+
+std::string lc3::core::AssemblyCache::getTempPath(std::string const & name) const
+{
+    // Other processes, and other caches in this one, may be writing the same entry at the same time.
+    static std::atomic<uint32_t> counter(0);
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32)
+    long pid = static_cast<long>(_getpid());
+#else
+    long pid = static_cast<long>(getpid());
+#endif
+    return getPath(lc3::utils::ssprintf("%s.%ld.%u.tmp", name.c_str(), pid, counter++));
+}
+
+std::vector<lc3::core::AssemblyCache::CacheFile> lc3::core::AssemblyCache::listFiles(void) const
+{
+    std::vector<CacheFile> files;
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32)
+    WIN32_FIND_DATAA data;
+    HANDLE handle = FindFirstFileA(getPath("*").c_str(), &data);
+    if(handle == INVALID_HANDLE_VALUE) {
+        return files;
+    }
+    do {
+        if((data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0) {
+            uint64_t size = (static_cast<uint64_t>(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+            // Convert from 100ns intervals since 1601 to seconds since 1970.
+            uint64_t mtime = (static_cast<uint64_t>(data.ftLastWriteTime.dwHighDateTime) << 32) |
+                data.ftLastWriteTime.dwLowDateTime;
+            files.push_back({data.cFileName, size, static_cast<int64_t>(mtime / 10000000) - 11644473600ll});
+        }
+    } while(FindNextFileA(handle, &data));
+    FindClose(handle);
+#else
+    DIR * dir = opendir(directory.c_str());
+    if(dir == nullptr) {
+        return files;
+    }
+    while(dirent * ent = readdir(dir)) {
+        struct stat info;
+        if(stat(getPath(ent->d_name).c_str(), &info) == 0 && S_ISREG(info.st_mode)) {
+            files.push_back({ent->d_name, static_cast<uint64_t>(info.st_size), static_cast<int64_t>(info.st_mtime)});
+        }
+    }
+    closedir(dir);
+#endif
+    return files;
+}
+
+void lc3::core::AssemblyCache::touch(std::string const & name) const
+{
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32)
+    _utime(getPath(name).c_str(), nullptr);
+#else
+    utime(getPath(name).c_str(), nullptr);
+#endif
+}
+
+void lc3::core::AssemblyCache::evict(std::string const & keep) const
+{
+    std::vector<CacheFile> entries;
+    uint64_t total_size = 0;
+    int64_t now = static_cast<int64_t>(std::time(nullptr));
+    for(CacheFile const & file : listFiles()) {
+        if(endsWith(file.name, ".cache")) {
+            entries.push_back(file);
+            total_size += file.size;
+        } else if(endsWith(file.name, ".tmp") && now - file.mtime > STALE_TEMP_AGE) {
+            std::remove(getPath(file.name).c_str());
+        }
+    }
+
+    // Another process may be evicting at the same time, in which case both may delete the same entries.
+    std::sort(entries.begin(), entries.end(), [](CacheFile const & a, CacheFile const & b) {
+        return a.mtime != b.mtime ? a.mtime < b.mtime : a.name < b.name;
+    });
+    for(CacheFile const & entry : entries) {
+        if(total_size <= max_size) {
+            break;
+        }
+        if(entry.name != keep) {
+            std::remove(getPath(entry.name).c_str());
+            total_size -= entry.size;
+        }
+    }
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#ifndef ASM_CACHE_H
+#define ASM_CACHE_H
+
+#include <string>
+#include <vector>
+
+#include "aliases.h"
+#include "object_sink.h"
+#include "utils.h"
+
+namespace lc3
+{
+namespace core
+{
+    // On-disk cache of assembled objects and their symbol tables. Entries are keyed on the source bytes, the liberal
+    // assembly flag, and the assembler version, and the least recently used entries are evicted once the cache grows
+    // beyond its size limit. The directory may be shared by concurrent processes: each entry is a separate file that
+    // is written under a name unique to the writer and then renamed into place, and recency is the modification time
+    // of the file, so there is no shared state to update.
+    class AssemblyCache
+    {
+    public:
+        AssemblyCache(std::string const & directory, uint64_t max_size);
+
+        // Writes the cached object into sink and returns its symbol table, or returns nothing if the source has not
+        // been cached.
+        optional<SymbolTable> lookup(std::string const & source, bool enable_liberal_asm, IObjectSink & sink);
+        void store(std::string const & source, bool enable_liberal_asm, ObjectMemorySink const & obj,
+            SymbolTable const & symbols);
+
+        std::string const & getDirectory(void) const { return directory; }
+
+    private:
+        struct CacheFile
+        {
+            std::string name;
+            uint64_t size;
+            int64_t mtime;
+        };
+
+        std::string directory;
+        uint64_t max_size;
+
+        std::string getKey(std::string const & source, bool enable_liberal_asm) const;
+        std::string getEntryName(std::string const & key) const;
+        std::string getPath(std::string const & name) const { return directory + "/" + name; }
+        std::string getTempPath(std::string const & name) const;
+
+        std::vector<CacheFile> listFiles(void) const;
+        // Mark the entry as the most recently used one.
+        void touch(std::string const & name) const;
+        // Delete the least recently used entries, other than keep, until the cache fits in max_size.
+        void evict(std::string const & keep) const;
+    };
+};
+};
+
+#endif
@@ -16,7 +16,6 @@ lc3::optional<uint32_t> lc3::core::asmbl::getNum(Statement const & statement, St
             if(log_enable) {
                 logger.asmPrintf(utils::PrintType::P_ERROR, statement, piece,
                     "cannot encode as %d-bit 2's complement number", width);
-                logger.newline();
             }
             return {};
         }
@@ -25,7 +24,6 @@ lc3::optional<uint32_t> lc3::core::asmbl::getNum(Statement const & statement, St
             if(log_enable) {
                 logger.asmPrintf(utils::PrintType::P_ERROR, statement, piece,
                     "cannot encode as %d-bit unsigned number", width);
-                logger.newline();
             }
             return {};
         }
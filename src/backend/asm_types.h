@@ -34,11 +34,13 @@ namespace asmbl
 
         std::string str;
         int32_t num;
+        // Set for a STRING that was written in quotes, e.g. the operand of a .stringz.
+        bool quoted;
 
         uint32_t row, col, len;
         std::string line;
 
-        Token(void) : type(Token::Type::INVALID), row(0), col(0), len(0) {}
+        Token(void) : type(Token::Type::INVALID), quoted(false), row(0), col(0), len(0) {}
 
     };
 
@@ -81,6 +83,8 @@ namespace asmbl
 
         std::string line;
         uint32_t row;
+        // File that the statement came from, if it was not the file being assembled (e.g. an .include'd file).
+        std::string filename;
 
         bool valid;
 
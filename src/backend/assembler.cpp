@@ -5,6 +5,8 @@
 #include <cassert>
 #include <cctype>
 #include <fstream>
+#include <iterator>
+#include <map>
 #include <sstream>
 #include <vector>
 
@@ -16,31 +18,165 @@
 #include "tokenizer.h"
 
 static constexpr uint32_t INST_NAME_CLOSENESS = 2;
+static constexpr uint32_t MAX_MACRO_DEPTH = 64;
 
 std::pair<std::shared_ptr<std::stringstream>, lc3::core::SymbolTable>
 lc3::core::Assembler::assemble(std::istream & buffer)
+{
+    AssemblerSession session;
+    return assemble(buffer, session);
+}
+
+std::pair<std::shared_ptr<std::stringstream>, lc3::core::SymbolTable>
+lc3::core::Assembler::assemble(std::istream & buffer, AssemblerSession & session)
+{
+    auto ret = std::make_shared<std::stringstream>(std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+    ObjectStreamSink sink(*ret);
+    SymbolTable symbols = assemble(buffer, session, sink);
+    return std::make_pair(ret, symbols);
+}
+
+lc3::core::SymbolTable lc3::core::Assembler::assemble(std::istream & buffer, IObjectSink & sink)
+{
+    AssemblerSession session;
+    return assemble(buffer, session, sink);
+}
+
+lc3::core::SymbolTable lc3::core::Assembler::assemble(std::istream & buffer, AssemblerSession & session,
+    IObjectSink & sink)
 {
     using namespace asmbl;
     using namespace lc3::utils;
 
     bool success = true;
     uint32_t fail_pass = 0;
+    uint32_t start_diagnostic_count = logger.getDiagnosticCount();
+    logger.clearDiagnostics();
+
+    std::vector<std::string> lines;
+    std::string line;
+    while(! Tokenizer::getline(buffer, line).eof()) {
+        lines.push_back(line);
+    }
+
+    if(session.enable_liberal_asm != enable_liberal_asm) {
+        session = AssemblerSession();
+        session.enable_liberal_asm = enable_liberal_asm;
+    }
+
+    // Find the lines that are unchanged from the previous assembly. Everything in between must be re-tokenized.
+    uint32_t prefix_lines = 0;
+    while(prefix_lines < lines.size() && prefix_lines < session.lines.size() &&
+        lines[prefix_lines] == session.lines[prefix_lines])
+    {
+        ++prefix_lines;
+    }
+    uint32_t suffix_lines = 0;
+    while(prefix_lines + suffix_lines < lines.size() && prefix_lines + suffix_lines < session.lines.size() &&
+        lines[lines.size() - suffix_lines - 1] == session.lines[session.lines.size() - suffix_lines - 1])
+    {
+        ++suffix_lines;
+    }
+
+    uint32_t prefix_statements = 0;
+    for(uint32_t i = 0; i < prefix_lines; i += 1) {
+        prefix_statements += session.line_has_statement[i] ? 1 : 0;
+    }
+    uint32_t suffix_statements = 0;
+    for(uint32_t i = session.lines.size() - suffix_lines; i < session.lines.size(); i += 1) {
+        suffix_statements += session.line_has_statement[i] ? 1 : 0;
+    }
 
     logger.printf(PrintType::P_EXTRA, true, "===== begin identifying tokens =====");
-    std::vector<Statement> statements = buildStatements(buffer);
+    std::vector<Statement> statements(session.statements.begin(), session.statements.begin() + prefix_statements);
+    std::vector<bool> line_has_statement(session.line_has_statement.begin(),
+        session.line_has_statement.begin() + prefix_lines);
+    for(uint32_t i = prefix_lines; i < lines.size() - suffix_lines; i += 1) {
+        optional<Statement> statement = buildStatement(lines[i], i);
+        if(statement) {
+            statements.push_back(*statement);
+        }
+        line_has_statement.push_back(static_cast<bool>(statement));
+    }
+    uint32_t first_suffix_statement = statements.size();
+    int32_t row_offset = static_cast<int32_t>(lines.size()) - static_cast<int32_t>(session.lines.size());
+    for(uint32_t i = session.statements.size() - suffix_statements; i < session.statements.size(); i += 1) {
+        Statement statement = session.statements[i];
+        // Statements built from a line without any tokens are not associated with a row.
+        if(! statement.line.empty()) {
+            statement.row += row_offset;
+        }
+        statements.push_back(statement);
+    }
+    line_has_statement.insert(line_has_statement.end(), session.line_has_statement.end() - suffix_lines,
+        session.line_has_statement.end());
     logger.printf(PrintType::P_EXTRA, true, "===== end identifying tokens =====");
     logger.newline(PrintType::P_EXTRA);
 
+    // The statements of a program with .include directives or macros do not line up with its lines once they are
+    // expanded, so only the tokenized lines of such a program are reused.
+    bool preprocess_statements = needsPreprocessing(statements);
+    included_files.clear();
+
+    // The PCs, symbols, and machine code of the previous assembly can only be reused if it did not produce any
+    // diagnostics. Otherwise, every statement is re-processed so that the diagnostics are reported again.
+    bool reuse = session.reusable && ! preprocess_statements;
+    uint32_t first_changed_statement = reuse ? prefix_statements : 0;
+    std::vector<PCState> pc_states(1);
+    if(reuse) {
+        pc_states.assign(session.pc_states.begin(), session.pc_states.begin() + first_changed_statement + 1);
+    }
+    for(uint32_t i = first_changed_statement; i < statements.size(); i += 1) {
+        statements[i].pc = 0;
+        statements[i].valid = true;
+    }
+
+    std::vector<EncodedStatement> old_encoded = std::move(session.encoded);
+    int32_t statement_offset = static_cast<int32_t>(statements.size()) -
+        static_cast<int32_t>(session.statements.size());
+
+    // Hold on to the tokenized statements even if a later pass fails.
+    session.lines = std::move(lines);
+    session.line_has_statement = std::move(line_has_statement);
+    session.statements = statements;
+    session.pc_states.clear();
+    session.encoded.clear();
+    session.reusable = false;
+
+    if(preprocess_statements) {
+        logger.printf(PrintType::P_EXTRA, true, "===== begin preprocessing =====");
+        std::vector<Statement> expanded_statements;
+        std::map<std::string, Macro> macros;
+        std::vector<std::string> include_stack{logger.filename};
+        success &= preprocess(statements, nullptr, expanded_statements, macros, include_stack, 0);
+        statements = std::move(expanded_statements);
+        logger.printf(PrintType::P_EXTRA, true, "===== end preprocessing =====");
+        logger.newline(PrintType::P_EXTRA);
+        logger.printDiagnostics();
+    }
+
     logger.printf(PrintType::P_EXTRA, true, "===== begin marking PCs =====");
-    setStatementPCField(statements);
+    setStatementPCField(statements, first_changed_statement, pc_states);
     logger.printf(PrintType::P_EXTRA, true, "===== end marking PCs =====");
     logger.newline(PrintType::P_EXTRA);
+    logger.printDiagnostics();
+    if(! preprocess_statements) {
+        session.statements = statements;
+    }
 
     logger.printf(PrintType::P_EXTRA, true, "===== begin building symbol table =====");
-    std::pair<bool, SymbolTable> symbols = buildSymbolTable(statements);
+    SymbolTable prefix_symbols;
+    for(uint32_t i = 0; i < first_changed_statement; i += 1) {
+        // A clean assembly adds the label of every statement that has one.
+        if(statements[i].label) {
+            prefix_symbols[utils::toLower(statements[i].label->str)] = statements[i].pc;
+        }
+    }
+    std::pair<bool, SymbolTable> symbols = buildSymbolTable(statements, first_changed_statement, prefix_symbols);
     success &= symbols.first;
     logger.printf(PrintType::P_EXTRA, true, "===== end building symbol table =====");
     logger.newline(PrintType::P_EXTRA);
+    logger.printDiagnostics();
     if(! success) {
         logger.printf(PrintType::P_ERROR, true, "pass 1 failed, attempting to continue to pass 2");
         logger.newline();
@@ -48,10 +184,27 @@ lc3::core::Assembler::assemble(std::istream & buffer)
     }
 
     logger.printf(PrintType::P_EXTRA, true, "===== begin assembling =====");
-    std::pair<bool, std::vector<MemLocation>> machine_code_blob = buildMachineCode(statements, symbols.second);
-    success &= machine_code_blob.first;
+    std::vector<EncodedStatement> encoded(statements.size());
+    for(uint32_t i = 0; i < statements.size(); i += 1) {
+        Statement const & statement = statements[i];
+        EncodedStatement & entry = encoded[i];
+
+        if(reuse && (i < prefix_statements || i >= first_suffix_statement)) {
+            EncodedStatement & old_entry = old_encoded[i < prefix_statements ? i : i - statement_offset];
+            if(isReusable(old_entry, statement, symbols.second)) {
+                entry = std::move(old_entry);
+                continue;
+            }
+        }
+
+        success &= buildMachineCode(statement, symbols.second, entry.words);
+        entry.pc = statement.pc;
+        entry.valid = statement.valid;
+        setSymbolRefs(entry, statement, symbols.second);
+    }
     logger.printf(PrintType::P_EXTRA, true, "===== end assembling =====");
     logger.newline(PrintType::P_EXTRA);
+    logger.printDiagnostics();
     if(! success && fail_pass == 0) {
         fail_pass = 2;
     }
@@ -65,41 +218,61 @@ lc3::core::Assembler::assemble(std::istream & buffer)
         throw lc3::utils::exception("assembly failed");
     }
 
-    auto ret = std::make_shared<std::stringstream>(std::ios_base::in | std::ios_base::out | std::ios_base::binary);
-    (*ret) << getMagicHeader();
-    (*ret) << getVersionString();
-    for(MemLocation const & entry : machine_code_blob.second) {
-        (*ret) << entry;
+    sink.begin();
+    for(EncodedStatement const & entry : encoded) {
+        for(MemLocation const & word : entry.words) {
+            sink.write(word);
+        }
     }
-    return std::make_pair(ret, symbols.second);
+    sink.end();
+
+    session.pc_states = std::move(pc_states);
+    session.encoded = std::move(encoded);
+    session.reusable = logger.getDiagnosticCount() == start_diagnostic_count && ! preprocess_statements;
+
+    return symbols.second;
 }
 
-std::vector<lc3::core::asmbl::Statement> lc3::core::Assembler::buildStatements(std::istream & buffer)
+lc3::optional<std::vector<lc3::core::asmbl::Token>> lc3::core::Assembler::tokenizeLine(std::string const & line,
+    uint32_t row)
 {
     using namespace asmbl;
     using namespace lc3::utils;
 
+    std::istringstream buffer(line);
     Tokenizer tokenizer{buffer, enable_liberal_asm};
-    std::vector<Statement> statements;
 
-    while(! tokenizer.isDone()) {
-        std::vector<Token> tokens;
-        Token cur_token;
-        while(! (tokenizer >> cur_token) && cur_token.type != Token::Type::EOL) {
-            tokens.push_back(cur_token);
+    std::vector<Token> tokens;
+    Token cur_token;
+    while(! (tokenizer >> cur_token) && cur_token.type != Token::Type::EOL) {
+        cur_token.row = row;
+        tokens.push_back(cur_token);
 #ifdef _ENABLE_DEBUG
+        if(logger.isLevelEnabled(PrintType::P_EXTRA)) {
             std::stringstream token_str;
             ::operator<<(token_str, cur_token);
             logger.printf(PrintType::P_EXTRA, true, " (token) %s", token_str.str().c_str());
-#endif
         }
+#endif
+    }
 
-        if(! tokenizer.isDone()) {
-            statements.push_back(buildStatement(tokens));
-        }
+    // The tokenizer skips lines that are empty after removing comments and whitespace.
+    if(tokenizer.isDone()) {
+        return {};
+    }
+
+    return tokens;
+}
+
+lc3::optional<lc3::core::asmbl::Statement> lc3::core::Assembler::buildStatement(std::string const & line,
+    uint32_t row)
+{
+    optional<std::vector<asmbl::Token>> tokens = tokenizeLine(line, row);
+    if(! tokens) {
+        return {};
     }
 
-    return statements;
+    return buildStatement(*tokens);
 }
 
 lc3::core::asmbl::Statement lc3::core::Assembler::buildStatement(
@@ -232,26 +405,342 @@ lc3::core::asmbl::Statement lc3::core::Assembler::buildStatement(
         }
     }
 
-    std::stringstream statement_str;
-    ::operator<<(statement_str, ret);
-    logger.printf(PrintType::P_EXTRA, true, "%s", statement_str.str().c_str());
+    if(logger.isLevelEnabled(PrintType::P_EXTRA)) {
+        std::stringstream statement_str;
+        ::operator<<(statement_str, ret);
+        logger.printf(PrintType::P_EXTRA, true, "%s", statement_str.str().c_str());
+    }
 
     return ret;
 }
 
-void lc3::core::Assembler::setStatementPCField(std::vector<lc3::core::asmbl::Statement> & statements)
+bool lc3::core::Assembler::needsPreprocessing(std::vector<lc3::core::asmbl::Statement> const & statements) const
+{
+    using namespace asmbl;
+
+    // Macros can only be used after being defined, so there is nothing to do without any .macro or .include.
+    for(Statement const & statement : statements) {
+        if(encoder.isPseudo(statement)) {
+            std::string base = utils::toLower(statement.base->str);
+            if(base == ".include" || base == ".macro") {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+static bool isMacroName(lc3::core::asmbl::Token const & token,
+    std::map<std::string, lc3::core::asmbl::Macro> const & macros)
+{
+    return token.type == lc3::core::asmbl::Token::Type::STRING && ! token.quoted &&
+        macros.find(lc3::utils::toLower(token.str)) != macros.end();
+}
+
+static bool mayInvokeMacro(lc3::core::asmbl::Statement const & statement,
+    std::map<std::string, lc3::core::asmbl::Macro> const & macros)
+{
+    using namespace lc3::core::asmbl;
+
+    // A macro name is either the first or second token of a statement, which must have been identified as the label,
+    // the base, or the first operand of a statement without a base.
+    std::vector<StatementPiece const *> pieces;
+    if(statement.label) { pieces.push_back(&(*statement.label)); }
+    if(statement.base) { pieces.push_back(&(*statement.base)); }
+    if(! statement.base && statement.operands.size() > 0) { pieces.push_back(&statement.operands[0]); }
+
+    for(StatementPiece const * piece : pieces) {
+        if(piece->type != StatementPiece::Type::NUM && macros.find(lc3::utils::toLower(piece->str)) != macros.end()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool lc3::core::Assembler::preprocess(std::vector<lc3::core::asmbl::Statement> const & statements,
+    std::vector<std::vector<lc3::core::asmbl::Token>> const * statement_tokens,
+    std::vector<lc3::core::asmbl::Statement> & ret, std::map<std::string, lc3::core::asmbl::Macro> & macros,
+    std::vector<std::string> & include_stack, uint32_t depth)
 {
     using namespace asmbl;
     using namespace lc3::utils;
 
-    uint32_t cur_idx = 0;
+    bool success = true;
+
+    for(uint32_t i = 0; i < statements.size(); i += 1) {
+        Statement const & statement = statements[i];
+        std::string base = encoder.isPseudo(statement) ? utils::toLower(statement.base->str) : "";
 
-    bool found_orig = false;
-    bool previous_region_ended = false;
-    uint32_t cur_pc = 0;
+        if(base == ".macro") {
+            success &= defineMacro(statements, statement_tokens, i, macros);
+            continue;
+        }
+
+        if(base == ".include") {
+            // Keep the label, which refers to the first statement of the included file.
+            if(statement.label) {
+                Statement label_statement = statement;
+                label_statement.base = optional<StatementPiece>();
+                label_statement.operands.clear();
+                ret.push_back(label_statement);
+            }
+
+            if(statement.operands.size() != 1 || statement.operands[0].type != StatementPiece::Type::STRING) {
+                logger.asmPrintf(PrintType::P_ERROR, statement, "invalid usage of .include");
+                logger.asmNote("expected '.include \"filename\"'");
+                success = false;
+                continue;
+            }
+
+            StatementPiece const & operand = statement.operands[0];
+            std::string filename = resolveIncludePath(statement, operand.str);
+            if(std::find(include_stack.begin(), include_stack.end(), filename) != include_stack.end()) {
+                logger.asmPrintf(PrintType::P_ERROR, statement, operand, "%s includes itself", filename.c_str());
+                success = false;
+                continue;
+            }
+
+            std::vector<Statement> const * included_statements = loadIncludedFile(filename);
+            if(included_statements == nullptr) {
+                logger.asmPrintf(PrintType::P_ERROR, statement, operand, "could not open %s", filename.c_str());
+                success = false;
+                continue;
+            }
+
+            logger.printf(PrintType::P_EXTRA, true, "including %s", filename.c_str());
+            included_files.push_back(filename);
+            include_stack.push_back(filename);
+            success &= preprocess(*included_statements, nullptr, ret, macros, include_stack, depth);
+            include_stack.pop_back();
+            continue;
+        }
+
+        if(macros.empty() || ! mayInvokeMacro(statement, macros)) {
+            ret.push_back(statement);
+            continue;
+        }
+
+        std::vector<Token> tokens = statement_tokens != nullptr ? (*statement_tokens)[i] :
+            *tokenizeLine(statement.line, statement.row);
+        uint32_t name_idx = 0;
+        if(! isMacroName(tokens[0], macros)) {
+            if(tokens.size() > 1 && isMacroName(tokens[1], macros)) {
+                name_idx = 1;
+            } else {
+                ret.push_back(statement);
+                continue;
+            }
+        }
+
+        std::string name = utils::toLower(tokens[name_idx].str);
+        Macro const & macro = macros.at(name);
+        if(name_idx == 1) {
+            Statement label_statement = buildStatement(std::vector<Token>{tokens[0]});
+            label_statement.filename = statement.filename;
+            ret.push_back(label_statement);
+        }
+
+        uint32_t num_args = static_cast<uint32_t>(tokens.size()) - name_idx - 1;
+        if(num_args != macro.params.size()) {
+            logger.asmPrintf(PrintType::P_ERROR, statement, "macro '%s' expects %d operand(s), but %d were given",
+                tokens[name_idx].str.c_str(), static_cast<uint32_t>(macro.params.size()), num_args);
+            success = false;
+            continue;
+        }
+
+        if(depth >= MAX_MACRO_DEPTH) {
+            logger.asmPrintf(PrintType::P_ERROR, statement, "expansion of macro '%s' is nested too deeply",
+                tokens[name_idx].str.c_str());
+            success = false;
+            continue;
+        }
+
+        logger.printf(PrintType::P_EXTRA, true, "expanding macro %s", name.c_str());
+        std::vector<Statement> expansion;
+        std::vector<std::vector<Token>> expansion_tokens;
+        for(std::vector<Token> body_tokens : macro.body) {
+            for(Token & token : body_tokens) {
+                // Quoted strings are left alone, so that e.g. a .stringz can contain a parameter's name.
+                if(token.type != Token::Type::STRING || token.quoted) {
+                    continue;
+                }
+
+                auto param = std::find(macro.params.begin(), macro.params.end(), utils::toLower(token.str));
+                if(param != macro.params.end()) {
+                    // Keep the position of the parameter so that diagnostics point into the body of the macro.
+                    Token const & arg = tokens[name_idx + 1 + (param - macro.params.begin())];
+                    token.type = arg.type;
+                    token.str = arg.str;
+                    token.num = arg.num;
+                    token.quoted = arg.quoted;
+                }
+            }
+
+            Statement expanded_statement = buildStatement(body_tokens);
+            expanded_statement.filename = macro.filename;
+            expansion.push_back(expanded_statement);
+            expansion_tokens.push_back(body_tokens);
+        }
+        success &= preprocess(expansion, &expansion_tokens, ret, macros, include_stack, depth + 1);
+    }
+
+    return success;
+}
+
+bool lc3::core::Assembler::defineMacro(std::vector<lc3::core::asmbl::Statement> const & statements,
+    std::vector<std::vector<lc3::core::asmbl::Token>> const * statement_tokens, uint32_t & idx,
+    std::map<std::string, lc3::core::asmbl::Macro> & macros)
+{
+    using namespace asmbl;
+    using namespace lc3::utils;
+
+    Statement const & statement = statements[idx];
+    bool success = true;
+
+    uint32_t end_idx = idx + 1;
+    while(end_idx < statements.size() && ! (encoder.isPseudo(statements[end_idx]) &&
+        utils::toLower(statements[end_idx].base->str) == ".endm"))
+    {
+        ++end_idx;
+    }
+
+    if(end_idx == statements.size()) {
+        logger.asmPrintf(PrintType::P_ERROR, statement, "missing .endm");
+        idx = end_idx;
+        return false;
+    }
+
+    if(statement.label) {
+        logger.asmPrintf(PrintType::P_ERROR, statement, *statement.label, "label cannot be attached to .macro");
+        success = false;
+    }
+
+    Macro macro;
+    macro.filename = statement.filename;
+    macro.row = statement.row;
+    std::string name;
+    if(statement.operands.size() == 0 || statement.operands[0].type != StatementPiece::Type::STRING) {
+        logger.asmPrintf(PrintType::P_ERROR, statement, "invalid usage of .macro");
+        logger.asmNote("expected '.macro name param param ...'");
+        success = false;
+    } else {
+        StatementPiece const & name_operand = statement.operands[0];
+        name = utils::toLower(name_operand.str);
+        if(encoder.getDistanceToNearestInstructionName(name) == 0) {
+            logger.asmPrintf(PrintType::P_ERROR, statement, name_operand, "macro name cannot be an instruction");
+            success = false;
+        } else if(macros.find(name) != macros.end()) {
+            // A file that is included more than once defines the same macro each time, which is harmless.
+            Macro const & existing = macros.at(name);
+            if(existing.filename == macro.filename && existing.row == macro.row) {
+                idx = end_idx;
+                return success;
+            }
+            logger.asmPrintf(PrintType::P_ERROR, statement, name_operand, "macro '%s' is already defined",
+                name_operand.str.c_str());
+            success = false;
+        }
+
+        for(uint32_t i = 1; i < statement.operands.size(); i += 1) {
+            StatementPiece const & param = statement.operands[i];
+            if(param.type != StatementPiece::Type::STRING) {
+                logger.asmPrintf(PrintType::P_ERROR, statement, param, "invalid macro parameter");
+                success = false;
+            } else {
+                macro.params.push_back(utils::toLower(param.str));
+            }
+        }
+    }
+
+    for(uint32_t i = idx + 1; i < end_idx; i += 1) {
+        if(statement_tokens != nullptr) {
+            macro.body.push_back((*statement_tokens)[i]);
+            continue;
+        }
+
+        optional<std::vector<Token>> tokens = tokenizeLine(statements[i].line, statements[i].row);
+        if(tokens) {
+            macro.body.push_back(*tokens);
+        }
+    }
+
+    if(success) {
+        macros[name] = macro;
+    }
+
+    idx = end_idx;
+    return success;
+}
+
+std::string lc3::core::Assembler::resolveIncludePath(lc3::core::asmbl::Statement const & statement,
+    std::string const & path) const
+{
+    if(path.empty() || path[0] == '/' || path[0] == '\\' || (path.size() > 1 && path[1] == ':')) {
+        return path;
+    }
+
+    // Relative paths are relative to the directory of the file that contains the .include.
+    std::string const & filename = statement.filename.empty() ? logger.filename : statement.filename;
+    size_t separator = filename.find_last_of("/\\");
+    if(separator == std::string::npos) {
+        return path;
+    }
+    return filename.substr(0, separator + 1) + path;
+}
+
+std::vector<lc3::core::asmbl::Statement> const * lc3::core::Assembler::loadIncludedFile(std::string const & filename)
+{
+    using namespace asmbl;
+    using namespace lc3::utils;
+
+    std::ifstream file(filename);
+    if(! file.is_open()) {
+        return nullptr;
+    }
+
+    std::string source((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    IncludedFile & included = include_cache[filename];
+    if(included.source != source || included.enable_liberal_asm != enable_liberal_asm) {
+        included.source = source;
+        included.enable_liberal_asm = enable_liberal_asm;
+        included.statements.clear();
+
+        std::istringstream buffer(source);
+        std::string line;
+        uint32_t row = 0;
+        while(! Tokenizer::getline(buffer, line).eof()) {
+            optional<Statement> statement = buildStatement(line, row);
+            if(statement) {
+                statement->filename = filename;
+                included.statements.push_back(*statement);
+            }
+            row += 1;
+        }
+    }
+
+    return &included.statements;
+}
+
+void lc3::core::Assembler::setStatementPCField(std::vector<lc3::core::asmbl::Statement> & statements,
+    uint32_t start_idx, std::vector<lc3::core::asmbl::PCState> & states)
+{
+    using namespace asmbl;
+    using namespace lc3::utils;
+
+    uint32_t cur_idx = start_idx;
+
+    // Resume from the state upon reaching the first statement, and record the state upon reaching every statement
+    // after it so that a later assembly can resume from any of them.
+    states.resize(statements.size() + 1);
+    PCState state = states[start_idx];
+    bool & found_orig = state.found_orig;
+    bool & previous_region_ended = state.previous_region_ended;
+    uint32_t & cur_pc = state.cur_pc;
 
     // Iterate over the statements, setting the current PC every time a new .orig is found.
     while(cur_idx < statements.size()) {
+        states[cur_idx] = state;
         Statement & statement = statements[cur_idx];
 
         if(encoder.isPseudo(statement)) {
@@ -264,7 +753,7 @@ void lc3::core::Assembler::setStatementPCField(std::vector<lc3::core::asmbl::Sta
                             // .orig was not ended properly.
                             logger.asmPrintf(PrintType::P_ERROR, statement,
                                 "new .orig found, but previous region did not have .end");
-                            logger.newline();
+                            logger.printDiagnostics();
                             throw utils::exception("new .orig fund, but previous region did not have .end");
                         }
                     }
@@ -311,7 +800,7 @@ void lc3::core::Assembler::setStatementPCField(std::vector<lc3::core::asmbl::Sta
             if(cur_pc >= MMIO_START) {
                 // If the PC has reached the MMIO region, abort!
                 logger.asmPrintf(PrintType::P_ERROR, statement, "cannot write code into memory-mapped I/O region");
-                logger.newline();
+                logger.printDiagnostics();
                 throw utils::exception("cannot write code into memory-mapped I/O region");
             }
 
@@ -344,6 +833,7 @@ void lc3::core::Assembler::setStatementPCField(std::vector<lc3::core::asmbl::Sta
 
         ++cur_idx;
     }
+    states[cur_idx] = state;
 
     // Trigger an error if there was no valid .orig in the file.
     if(! found_orig) {
@@ -363,26 +853,24 @@ void lc3::core::Assembler::setStatementPCField(std::vector<lc3::core::asmbl::Sta
 }
 
 std::pair<bool, lc3::core::SymbolTable> lc3::core::Assembler::buildSymbolTable(
-    std::vector<lc3::core::asmbl::Statement> const & statements)
+    std::vector<lc3::core::asmbl::Statement> const & statements, uint32_t start_idx, lc3::core::SymbolTable symbols)
 {
     using namespace asmbl;
     using namespace lc3::utils;
 
-    SymbolTable symbols;
     bool success = true;
 
-    for(Statement const & statement : statements) {
+    for(uint32_t i = start_idx; i < statements.size(); i += 1) {
+        Statement const & statement = statements[i];
         if(statement.label) {
             if(statement.label->type == StatementPiece::Type::NUM) {
                 logger.asmPrintf(PrintType::P_ERROR, statement, *statement.label, "label cannot be a numeric value");
-                logger.newline();
                 success = false;
             } else {
                 if(! statement.base) {
                     if(statement.operands.size() > 0) {
                         for(StatementPiece const & operand : statement.operands) {
                             logger.asmPrintf(PrintType::P_ERROR, statement, operand, "illegal operand to a label");
-                            logger.newline();
                         }
                         success = false;
                         continue;
@@ -392,7 +880,6 @@ std::pair<bool, lc3::core::SymbolTable> lc3::core::Assembler::buildSymbolTable(
                          *if(! enable_liberal_asm) {
                          *    logger.asmPrintf(PrintType::P_ERROR, statement, *statement.label,
                          *        "cannot have label on its own line");
-                         *    logger.newline();
                          *    success = false;
                          *    continue;
                          *}
@@ -407,12 +894,10 @@ std::pair<bool, lc3::core::SymbolTable> lc3::core::Assembler::buildSymbolTable(
                         logger.asmPrintf(PrintType::P_WARNING, statement, *statement.label,
                             "redefining label \'%s\' from 0x%0.4x to 0x%0.4x", statement.label->str.c_str(),
                             old_val, statement.pc);
-                        logger.newline(PrintType::P_WARNING);
                     } else {
                         logger.asmPrintf(PrintType::P_ERROR, statement, *statement.label,
                             "attempting to redefine label \'%s\' from 0x%0.4x to 0x%0.4x", statement.label->str.c_str(),
                             old_val, statement.pc);
-                        logger.newline();
                         success = false;
                         continue;
                     }
@@ -422,7 +907,6 @@ std::pair<bool, lc3::core::SymbolTable> lc3::core::Assembler::buildSymbolTable(
                     if('0' <= statement.label->str[0] && statement.label->str[0] <= '9') {
                         logger.asmPrintf(PrintType::P_ERROR, statement, *statement.label,
                             "label cannot begin with number");
-                        logger.newline();
                         success = false;
                         continue;
                     }
@@ -430,7 +914,6 @@ std::pair<bool, lc3::core::SymbolTable> lc3::core::Assembler::buildSymbolTable(
                     if(encoder.getDistanceToNearestInstructionName(statement.label->str) == 0) {
                         logger.asmPrintf(PrintType::P_ERROR, statement, *statement.label,
                             "label cannot be an instruction");
-                        logger.newline();
                         success = false;
                         continue;
                     }
@@ -439,7 +922,6 @@ std::pair<bool, lc3::core::SymbolTable> lc3::core::Assembler::buildSymbolTable(
                 if(encoder.isStringValidReg(statement.label->str)) {
                     logger.asmPrintf(PrintType::P_ERROR, statement, *statement.label,
                         "label cannot be a register");
-                    logger.newline();
                     success = false;
                     continue;
                 }
@@ -454,102 +936,143 @@ std::pair<bool, lc3::core::SymbolTable> lc3::core::Assembler::buildSymbolTable(
     return std::make_pair(success, symbols);
 }
 
-std::pair<bool, std::vector<lc3::core::MemLocation>> lc3::core::Assembler::buildMachineCode(
-    std::vector<lc3::core::asmbl::Statement> const & statements, lc3::core::SymbolTable const & symbols)
+bool lc3::core::Assembler::buildMachineCode(lc3::core::asmbl::Statement const & statement,
+    lc3::core::SymbolTable const & symbols, std::vector<lc3::core::MemLocation> & ret)
 {
     using namespace asmbl;
     using namespace lc3::utils;
 
     bool success = true;
 
-    std::vector<MemLocation> ret;
+    if(! statement.valid) {
+        if(enable_liberal_asm) {
+            logger.asmPrintf(PrintType::P_WARNING, statement, "ignoring statement whose address cannot be determined");
+        } else {
+            logger.asmPrintf(PrintType::P_ERROR, statement, "cannot determine address for statement");
+            success = false;
+        }
+        return success;
+    }
 
-    for(Statement const & statement : statements) {
-        if(! statement.valid) {
-            if(enable_liberal_asm) {
-                logger.asmPrintf(PrintType::P_WARNING, statement, "ignoring statement whose address cannot be determined");
-                logger.newline(PrintType::P_WARNING);
-            } else {
-                logger.asmPrintf(PrintType::P_ERROR, statement, "cannot determine address for statement");
-                logger.newline();
-                success = false;
-            }
-            continue;
+    if(statement.base) {
+        // Formatting the trace is relatively expensive, so only do it if it will be printed.
+        bool trace = logger.isLevelEnabled(PrintType::P_EXTRA);
+        std::string msg;
+        if(trace) {
+            std::stringstream statement_str;
+            ::operator<<(statement_str, statement) << " := ";
+            msg = statement_str.str();
         }
 
-        if(statement.base) {
-            std::stringstream msg;
-            ::operator<<(msg, statement) << " := ";
-
-            if(encoder.isPseudo(statement)) {
-                bool valid = encoder.validatePseudo(statement, symbols);
-                if(valid) {
-                    if(encoder.isValidPseudoOrig(statement)) {
-                        uint32_t address = encoder.getPseudoOrig(statement);
-                        ret.emplace_back(address, statement.line, true);
-                        msg << utils::ssprintf("(orig) 0x%0.4x", address);
-                    } else if(encoder.isValidPseudoFill(statement, symbols)) {
-                        uint32_t value = encoder.getPseudoFill(statement, symbols);
-                        ret.emplace_back(value, statement.line, false);
-                        msg << utils::ssprintf("0x%0.4x", value);
-                    } else if(encoder.isValidPseudoBlock(statement)) {
-                        uint32_t size = encoder.getPseudoBlockSize(statement);
-                        for(uint32_t i = 0; i < size; i += 1) {
-                            ret.emplace_back(0, statement.line, false);
-                        }
-                        msg << utils::ssprintf("mem[0x%0.4x:0x%04x] = 0", statement.pc, statement.pc + size - 1);
-                    } else if(encoder.isValidPseudoString(statement)) {
-                        std::string const & value = encoder.getPseudoString(statement);
-                        for(char c : value) {
-                            ret.emplace_back(c, std::string(1, c), false);
-                        }
+        if(encoder.isPseudo(statement)) {
+            bool valid = encoder.validatePseudo(statement, symbols);
+            if(valid) {
+                if(encoder.isValidPseudoOrig(statement)) {
+                    uint32_t address = encoder.getPseudoOrig(statement);
+                    ret.emplace_back(address, statement.line, true);
+                    if(trace) { msg += utils::ssprintf("(orig) 0x%0.4x", address); }
+                } else if(encoder.isValidPseudoFill(statement, symbols)) {
+                    uint32_t value = encoder.getPseudoFill(statement, symbols);
+                    ret.emplace_back(value, statement.line, false);
+                    if(trace) { msg += utils::ssprintf("0x%0.4x", value); }
+                } else if(encoder.isValidPseudoBlock(statement)) {
+                    uint32_t size = encoder.getPseudoBlockSize(statement);
+                    for(uint32_t i = 0; i < size; i += 1) {
                         ret.emplace_back(0, statement.line, false);
-                        msg << utils::ssprintf("mem[0x%0.4x:0x%04x] = \'%s\\0\'", statement.pc,
-                            statement.pc + value.size(), value.c_str());
-                    } else if(encoder.isValidPseudoEnd(statement)) {
-                        msg << "(end)";
-                    } else {
-#ifdef _ENABLE_DEBUG
-                        // This should never happen because we already validated the pseudo-op.
-                        assert(false);
-#endif
                     }
-
-                    if(valid) {
-                        logger.printf(PrintType::P_EXTRA, true, "%s", msg.str().c_str());
-                    } else {
-                        logger.printf(PrintType::P_EXTRA, true, "%s not assembled", msg.str().c_str());
+                    if(trace) {
+                        msg += utils::ssprintf("mem[0x%0.4x:0x%04x] = 0", statement.pc, statement.pc + size - 1);
                     }
-                }
-                success &= valid;
-            } else if(encoder.isInst(statement)) {
-                logger.printf(PrintType::P_EXTRA, true, "%s", msg.str().c_str());
-                bool valid = false;
-                optional<PIInstruction> candidate = encoder.validateInstruction(statement);
-                if(candidate) {
-                    optional<uint32_t> value = encoder.encodeInstruction(statement, symbols, *candidate);
-                    if(value) {
-                        ret.emplace_back(*value, statement.line, false);
-                        msg << utils::ssprintf("0x%0.4x", *value);
-                        valid = true;
-                        logger.printf(PrintType::P_EXTRA, true, "  0x%0.4x", *value);
+                } else if(encoder.isValidPseudoString(statement)) {
+                    std::string const & value = encoder.getPseudoString(statement);
+                    for(char c : value) {
+                        ret.emplace_back(c, std::string(1, c), false);
+                    }
+                    ret.emplace_back(0, statement.line, false);
+                    if(trace) {
+                        msg += utils::ssprintf("mem[0x%0.4x:0x%04x] = \'%s\\0\'", statement.pc,
+                            statement.pc + value.size(), value.c_str());
                     }
+                } else if(encoder.isValidPseudoEnd(statement)) {
+                    msg += "(end)";
+                } else {
+#ifdef _ENABLE_DEBUG
+                    // This should never happen because we already validated the pseudo-op.
+                    assert(false);
+#endif
                 }
 
-                if(! valid) {
-                    logger.printf(PrintType::P_EXTRA, true, "  not assembled");
+                logger.printf(PrintType::P_EXTRA, true, "%s", msg.c_str());
+            }
+            success &= valid;
+        } else if(encoder.isInst(statement)) {
+            logger.printf(PrintType::P_EXTRA, true, "%s", msg.c_str());
+            bool valid = false;
+            optional<PIInstruction> candidate = encoder.validateInstruction(statement);
+            if(candidate) {
+                optional<uint32_t> value = encoder.encodeInstruction(statement, symbols, *candidate);
+                if(value) {
+                    ret.emplace_back(*value, statement.line, false);
+                    valid = true;
+                    logger.printf(PrintType::P_EXTRA, true, "  0x%0.4x", *value);
                 }
-                success &= valid;
-            } else {
+            }
+
+            if(! valid) {
+                logger.printf(PrintType::P_EXTRA, true, "  not assembled");
+            }
+            success &= valid;
+        } else {
 #ifdef _ENABLE_DEBUG
-                // buildStatement should never assign the base field anything other than INST or PSEUDO.
-                assert(false);
+            // buildStatement should never assign the base field anything other than INST or PSEUDO.
+            assert(false);
 #endif
-            }
         }
     }
 
-    return std::make_pair(success, ret);
+    return success;
+}
+
+bool lc3::core::Assembler::isReusable(lc3::core::asmbl::EncodedStatement const & encoded,
+    lc3::core::asmbl::Statement const & statement, lc3::core::SymbolTable const & symbols) const
+{
+    if(! encoded.reusable || encoded.pc != statement.pc || encoded.valid != statement.valid) {
+        return false;
+    }
+
+    for(std::pair<std::string, uint32_t> const & ref : encoded.symbol_refs) {
+        auto search = symbols.find(ref.first);
+        if(search == symbols.end() || search->second != ref.second) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void lc3::core::Assembler::setSymbolRefs(lc3::core::asmbl::EncodedStatement & encoded,
+    lc3::core::asmbl::Statement const & statement, lc3::core::SymbolTable const & symbols) const
+{
+    using namespace asmbl;
+
+    encoded.reusable = true;
+    encoded.symbol_refs.clear();
+
+    // The operand of a .stringz is never a label.
+    if(! statement.base || encoder.isValidPseudoString(statement)) {
+        return;
+    }
+
+    for(StatementPiece const & operand : statement.operands) {
+        if(operand.type == StatementPiece::Type::STRING) {
+            auto search = symbols.find(utils::toLower(operand.str));
+            if(search == symbols.end()) {
+                encoded.reusable = false;
+                return;
+            }
+            encoded.symbol_refs.emplace_back(search->first, search->second);
+        }
+    }
 }
 
 void lc3::core::Assembler::setLiberalAsm(bool enable_liberal_asm)
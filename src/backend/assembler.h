@@ -4,12 +4,14 @@
 #ifndef ASSEMBLER_H
 #define ASSEMBLER_H
 
+#include <map>
 #include <memory>
 #include <sstream>
 #include <vector>
 
 #include "encoder.h"
 #include "logger.h"
+#include "object_sink.h"
 #include "printer.h"
 #include "tokenizer.h"
 #include "utils.h"
@@ -18,6 +20,69 @@ namespace lc3
 {
 namespace core
 {
+namespace asmbl
+{
+    // State of the PC marking pass upon reaching a statement.
+    struct PCState
+    {
+        PCState(void) : found_orig(false), previous_region_ended(false), cur_pc(0) {}
+
+        bool found_orig;
+        bool previous_region_ended;
+        uint32_t cur_pc;
+    };
+
+    // Machine code generated for a single statement, along with everything the encoding depended on.
+    struct EncodedStatement
+    {
+        EncodedStatement(void) : reusable(false), pc(0), valid(false) {}
+
+        bool reusable;
+        uint32_t pc;
+        bool valid;
+        std::vector<std::pair<std::string, uint32_t>> symbol_refs;
+        std::vector<MemLocation> words;
+    };
+
+    // Macro defined by a .macro/.endm block. Tokens of the body that match a parameter name are replaced by the
+    // corresponding argument upon expansion.
+    struct Macro
+    {
+        std::vector<std::string> params;
+        std::vector<std::vector<Token>> body;
+        std::string filename;
+        uint32_t row;
+    };
+
+    // Statements of an .include'd file, which are re-used as long as the file does not change.
+    struct IncludedFile
+    {
+        IncludedFile(void) : enable_liberal_asm(false) {}
+
+        std::string source;
+        bool enable_liberal_asm;
+        std::vector<Statement> statements;
+    };
+};
+
+    // Results of a previous assembly of a source file. Passing the same session to subsequent assemblies of an edited
+    // version of the file allows the assembler to only re-process the statements affected by the edit. The output is
+    // always identical to that of a clean assembly.
+    struct AssemblerSession
+    {
+        AssemblerSession(void) : enable_liberal_asm(false), reusable(false) {}
+
+        std::vector<std::string> lines;
+        std::vector<bool> line_has_statement;
+        std::vector<asmbl::Statement> statements;
+        std::vector<asmbl::PCState> pc_states;
+        std::vector<asmbl::EncodedStatement> encoded;
+        bool enable_liberal_asm;
+        // Set only if the previous assembly succeeded without any warnings, in which case its PCs, symbols, and
+        // machine code can be reused as is.
+        bool reusable;
+    };
+
     class Assembler
     {
     public:
@@ -29,9 +94,20 @@ namespace core
         ~Assembler(void) = default;
 
         std::pair<std::shared_ptr<std::stringstream>, SymbolTable> assemble(std::istream & buffer);
+        std::pair<std::shared_ptr<std::stringstream>, SymbolTable> assemble(std::istream & buffer,
+            AssemblerSession & session);
+        // Write the object directly to a sink. Nothing is written to the sink if the assembly fails.
+        SymbolTable assemble(std::istream & buffer, IObjectSink & sink);
+        SymbolTable assemble(std::istream & buffer, AssemblerSession & session, IObjectSink & sink);
         void setFilename(std::string const & filename) { logger.setFilename(filename); }
+        // Warnings and errors reported by the most recent assembly.
+        std::vector<utils::AssemblerDiagnostic> const & getDiagnostics(void) const { return logger.getDiagnostics(); }
+        void clearDiagnostics(void) { logger.clearDiagnostics(); }
 
         void setLiberalAsm(bool enable_liberal_asm);
+        bool getLiberalAsm(void) const { return enable_liberal_asm; }
+        // Files that were .include'd by the most recent assembly.
+        std::vector<std::string> const & getIncludedFiles(void) const { return included_files; }
 
     private:
         std::vector<std::string> file_buffer;
@@ -40,12 +116,33 @@ namespace core
 
         asmbl::Encoder encoder;
 
-        std::vector<asmbl::Statement> buildStatements(std::istream & buffer);
+        std::map<std::string, asmbl::IncludedFile> include_cache;
+        std::vector<std::string> included_files;
+
+        optional<std::vector<asmbl::Token>> tokenizeLine(std::string const & line, uint32_t row);
+        optional<asmbl::Statement> buildStatement(std::string const & line, uint32_t row);
         asmbl::Statement buildStatement(std::vector<asmbl::Token> const & tokens);
-        void setStatementPCField(std::vector<asmbl::Statement> & statements);
-        std::pair<bool, SymbolTable> buildSymbolTable(std::vector<asmbl::Statement> const & statements);
-        std::pair<bool, std::vector<MemLocation>> buildMachineCode(std::vector<asmbl::Statement> const & statements,
-            SymbolTable const & symbols);
+        bool needsPreprocessing(std::vector<asmbl::Statement> const & statements) const;
+        // statement_tokens holds the tokens of each statement of a macro expansion, which differ from its line once
+        // parameters have been substituted. It is null for statements that came straight from a file.
+        bool preprocess(std::vector<asmbl::Statement> const & statements,
+            std::vector<std::vector<asmbl::Token>> const * statement_tokens, std::vector<asmbl::Statement> & ret,
+            std::map<std::string, asmbl::Macro> & macros, std::vector<std::string> & include_stack, uint32_t depth);
+        bool defineMacro(std::vector<asmbl::Statement> const & statements,
+            std::vector<std::vector<asmbl::Token>> const * statement_tokens, uint32_t & idx,
+            std::map<std::string, asmbl::Macro> & macros);
+        std::vector<asmbl::Statement> const * loadIncludedFile(std::string const & filename);
+        std::string resolveIncludePath(asmbl::Statement const & statement, std::string const & path) const;
+        void setStatementPCField(std::vector<asmbl::Statement> & statements, uint32_t start_idx,
+            std::vector<asmbl::PCState> & states);
+        std::pair<bool, SymbolTable> buildSymbolTable(std::vector<asmbl::Statement> const & statements,
+            uint32_t start_idx, SymbolTable symbols);
+        bool buildMachineCode(asmbl::Statement const & statement, SymbolTable const & symbols,
+            std::vector<MemLocation> & ret);
+        bool isReusable(asmbl::EncodedStatement const & encoded, asmbl::Statement const & statement,
+            SymbolTable const & symbols) const;
+        void setSymbolRefs(asmbl::EncodedStatement & encoded, asmbl::Statement const & statement,
+            SymbolTable const & symbols) const;
     };
 };
 };
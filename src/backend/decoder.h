@@ -4,6 +4,8 @@
 #ifndef DECODER_H
 #define DECODER_H
 
+#include <array>
+
 #include "isa_abstract.h"
 #include "utils.h"
 
@@ -21,7 +23,9 @@ namespace sim
         optional<PIInstruction> decode(uint16_t value) const;
 
     private:
-        std::map<uint16_t, std::vector<PIInstruction>> instructions_by_opcode;
+        // Decoding sets the values of the operands, so each decoder has its own instructions.
+        std::vector<PIInstruction> instructions;
+        std::array<uint8_t, 1 << 16> const & decode_table;
     };
 };
 };
@@ -14,6 +14,11 @@ std::pair<uint16_t, PIMicroOp> RWReg::read(uint16_t addr)
     return std::make_pair(0x0000, nullptr);
 }
 
+uint16_t RWReg::peek(uint16_t addr) const
+{
+    return addr == data_addr ? data.getValue() : 0x0000;
+}
+
 PIMicroOp RWReg::write(uint16_t addr, uint16_t value)
 {
     if(addr == data_addr) {
@@ -72,6 +77,17 @@ std::pair<uint16_t, PIMicroOp> KeyboardDevice::read(uint16_t addr)
     return std::make_pair(0x0000, nullptr);
 }
 
+uint16_t KeyboardDevice::peek(uint16_t addr) const
+{
+    if(addr == KBSR) {
+        return status.getValue();
+    } else if(addr == KBDR) {
+        return data.getValue();
+    }
+
+    return 0x0000;
+}
+
 PIMicroOp KeyboardDevice::write(uint16_t addr, uint16_t value)
 {
     if(addr == KBSR) {
@@ -100,13 +116,39 @@ PIMicroOp KeyboardDevice::tick(void)
 
         if(! key_buffer.front().triggered_interrupt && (status.getValue() & 0x4000) == 0x4000) {
             key_buffer.front().triggered_interrupt = true;
-            return std::make_shared<PushInterruptTypeMicroOp>(InterruptType::KEYBOARD);
+            return std::make_shared<PushInterruptTypeMicroOp>(Interrupt(InterruptType::KEYBOARD));
         }
     }
 
     return nullptr;
 }
 
+uint64_t KeyboardDevice::getIdleTicks(void) const
+{
+    // Once a pending key has been reported by the ready bit and, if enabled, an interrupt, ticking only changes the
+    // device when the inputter delivers another key.
+    if(! key_buffer.empty() && (utils::getBit(status.getValue(), 15) == 0 ||
+        data.getValue() != static_cast<uint16_t>(key_buffer.front().value) ||
+        (! key_buffer.front().triggered_interrupt && utils::getBit(status.getValue(), 14) == 1)))
+    {
+        return 0;
+    }
+
+    return inputter.getIdleCount();
+}
+
+bool KeyboardDevice::takeKey(uint16_t & value)
+{
+    if(utils::getBit(status.getValue(), 15) == 0) {
+        return false;
+    }
+
+    value = data.getValue();
+    status.setValue(status.getValue() & 0x4000);
+    key_buffer.pop();
+    return true;
+}
+
 std::pair<uint16_t, PIMicroOp> DisplayDevice::read(uint16_t addr)
 {
     if(addr == DSR) {
@@ -116,6 +158,11 @@ std::pair<uint16_t, PIMicroOp> DisplayDevice::read(uint16_t addr)
     return std::make_pair(0x0000, nullptr);
 }
 
+uint16_t DisplayDevice::peek(uint16_t addr) const
+{
+    return addr == DSR ? status.getValue() : 0x0000;
+}
+
 DisplayDevice::DisplayDevice(lc3::utils::Logger & logger) : logger(logger)
 {
     status.setValue(0x0000);
@@ -143,6 +190,30 @@ PIMicroOp DisplayDevice::write(uint16_t addr, uint16_t value)
     return nullptr;
 }
 
+void DisplayDevice::writeString(std::string const & str)
+{
+    if(str.empty()) {
+        return;
+    }
+
+    std::string::size_type start = 0;
+    for(std::string::size_type i = 0; i < str.size(); i += 1) {
+        if(str[i] == 10 || str[i] == 13) {
+            if(i > start) {
+                logger.print(str.substr(start, i - start));
+            }
+            logger.newline(utils::PrintType::P_NONE);
+            start = i + 1;
+        }
+    }
+    if(start < str.size()) {
+        logger.print(str.substr(start));
+    }
+
+    status.setValue(status.getValue() & 0x7FFF);
+    data.setValue(static_cast<uint16_t>(static_cast<unsigned char>(str.back())));
+}
+
 std::vector<uint16_t> DisplayDevice::getAddrMap(void) const
 {
     return { DSR, DDR };
@@ -155,3 +226,92 @@ PIMicroOp DisplayDevice::tick(void)
 
     return nullptr;
 }
+
+uint64_t DisplayDevice::getIdleTicks(void) const
+{
+    // Ticking only sets the ready bit.
+    return utils::getBit(status.getValue(), 15) == 1 ? std::numeric_limits<uint64_t>::max() : 0;
+}
+
+TimerDevice::TimerDevice(IDeviceScheduler & scheduler) : scheduler(scheduler), control(0x0000), reload(0x0000),
+    vector(getInterruptVector(InterruptType::TIMER)), expiry(0)
+{}
+
+std::pair<uint16_t, PIMicroOp> TimerDevice::read(uint16_t addr)
+{
+    return std::make_pair(peek(addr), nullptr);
+}
+
+uint16_t TimerDevice::peek(uint16_t addr) const
+{
+    if(addr == TMCR) {
+        return control;
+    } else if(addr == TMRR) {
+        return reload;
+    } else if(addr == TMVR) {
+        return vector;
+    } else if(addr == TMCNT) {
+        uint64_t inst_count = scheduler.getInstCount();
+        return isRunning() && expiry > inst_count ? static_cast<uint16_t>(expiry - inst_count) : 0x0000;
+    }
+
+    return 0x0000;
+}
+
+PIMicroOp TimerDevice::write(uint16_t addr, uint16_t value)
+{
+    if(addr == TMCR) {
+        bool was_running = isRunning();
+        control = value & 0x4003;
+        if(! was_running && isRunning()) {
+            restart();
+        }
+    } else if(addr == TMRR) {
+        reload = value;
+        if(isRunning()) {
+            restart();
+        }
+    } else if(addr == TMVR) {
+        vector = value & 0x00FF;
+    }
+
+    return nullptr;
+}
+
+std::vector<uint16_t> TimerDevice::getAddrMap(void) const
+{
+    return { TMCR, TMRR, TMVR, TMCNT };
+}
+
+PIMicroOp TimerDevice::tick(void)
+{
+    // Ticks that were scheduled before the timer was stopped or restarted are stale.
+    if(! isRunning() || scheduler.getInstCount() < expiry) {
+        return nullptr;
+    }
+
+    // Only one interrupt is raised until the previous expiration is acknowledged.
+    bool acknowledged = (control & 0x8000) == 0;
+    control |= 0x8000;
+
+    if((control & 0x0002) != 0) {
+        expiry += reload;
+        scheduler.scheduleTick(expiry, shared_from_this());
+    } else {
+        control &= 0xFFFE;
+    }
+
+    if(acknowledged && (control & 0x4000) != 0) {
+        return std::make_shared<PushInterruptTypeMicroOp>(Interrupt(InterruptType::TIMER,
+            static_cast<uint8_t>(vector), getInterruptPriority(InterruptType::TIMER)));
+    }
+
+    return nullptr;
+}
+
+void TimerDevice::restart(void)
+{
+    // The countdown starts after the instruction that started the timer.
+    expiry = scheduler.getInstCount() + 1 + reload;
+    scheduler.scheduleTick(expiry, shared_from_this());
+}
@@ -4,6 +4,7 @@
 #ifndef DEVICE_H
 #define DEVICE_H
 
+#include <limits>
 #include <memory>
 #include <vector>
 #include <queue>
@@ -19,6 +20,19 @@ namespace lc3
 {
 namespace core
 {
+    // Lets a device ask to be updated right before a particular instruction, rather than before every instruction.
+    class IDeviceScheduler
+    {
+    public:
+        virtual ~IDeviceScheduler(void) = default;
+
+        // Number of instructions executed since the simulator was created.
+        virtual uint64_t getInstCount(void) const = 0;
+        // Tick device right before the instruction numbered inst_count (counting from 0) is executed, or before the
+        // next instruction if inst_count has already passed.
+        virtual void scheduleTick(uint64_t inst_count, PIDevice device) = 0;
+    };
+
     class IDevice
     {
     public:
@@ -28,10 +42,18 @@ namespace core
         virtual void startup(void) { }
         virtual void shutdown(void) { }
         virtual std::pair<uint16_t, PIMicroOp> read(uint16_t addr) = 0;
+        // Value that read() would return, but without any of the side effects of reading the register.
+        virtual uint16_t peek(uint16_t addr) const = 0;
         virtual PIMicroOp write(uint16_t addr, uint16_t value) = 0;
         virtual std::vector<uint16_t> getAddrMap(void) const = 0;
         virtual std::string getName(void) const = 0;
         virtual PIMicroOp tick(void) { return nullptr; }
+        // Devices that return false are only ticked when they schedule a tick.
+        virtual bool needsTick(void) const { return true; }
+        // Number of upcoming ticks that are certain not to change any register or raise an interrupt. The simulator
+        // may skip over a loop that polls a device for that many ticks, calling skipTicks instead of tick.
+        virtual uint64_t getIdleTicks(void) const { return 0; }
+        virtual void skipTicks(uint64_t) {}
     };
 
     class RWReg : public IDevice
@@ -41,9 +63,11 @@ namespace core
         virtual ~RWReg(void) override = default;
 
         virtual std::pair<uint16_t, PIMicroOp> read(uint16_t addr) override;
+        virtual uint16_t peek(uint16_t addr) const override;
         virtual PIMicroOp write(uint16_t addr, uint16_t value) override;
         virtual std::vector<uint16_t> getAddrMap(void) const override;
         virtual std::string getName(void) const override { return "RWReg"; }
+        virtual uint64_t getIdleTicks(void) const override { return std::numeric_limits<uint64_t>::max(); }
 
     private:
         MemLocation data;
@@ -59,10 +83,16 @@ namespace core
         virtual void startup(void) override;
         virtual void shutdown(void) override;
         virtual std::pair<uint16_t, PIMicroOp> read(uint16_t addr) override;
+        virtual uint16_t peek(uint16_t addr) const override;
         virtual PIMicroOp write(uint16_t addr, uint16_t value) override;
         virtual std::vector<uint16_t> getAddrMap(void) const override;
         virtual std::string getName(void) const override { return "Keyboard"; }
         virtual PIMicroOp tick(void) override;
+        virtual uint64_t getIdleTicks(void) const override;
+        virtual void skipTicks(uint64_t count) override { inputter.skipIdle(count); }
+
+        // Take the pending key, leaving the device as if KBDR had been read. Returns false if no key is pending.
+        bool takeKey(uint16_t & value);
 
     private:
         lc3::utils::IInputter & inputter;
@@ -89,10 +119,15 @@ namespace core
         virtual ~DisplayDevice(void) override = default;
 
         virtual std::pair<uint16_t, PIMicroOp> read(uint16_t addr) override;
+        virtual uint16_t peek(uint16_t addr) const override;
         virtual PIMicroOp write(uint16_t addr, uint16_t value) override;
         virtual std::vector<uint16_t> getAddrMap(void) const override;
         virtual std::string getName(void) const override { return "Display"; }
         virtual PIMicroOp tick(void) override;
+        virtual uint64_t getIdleTicks(void) const override;
+
+        // Print a whole string at once, leaving the device as if each character had been written to DDR in turn.
+        void writeString(std::string const & str);
 
     private:
         lc3::utils::Logger & logger;
@@ -100,6 +135,35 @@ namespace core
         MemLocation status;
         MemLocation data;
     };
+
+    // Counts down TMRR instructions and then sets the ready bit (bit 15) of TMCR and, if interrupts are enabled (bit
+    // 14), raises an interrupt at the vector in TMVR. Bit 0 of TMCR starts the timer, which restarts the countdown
+    // whenever TMRR is written. If bit 1 is set, the timer repeats; otherwise it stops after expiring. Writing TMCR
+    // clears the ready bit, which acknowledges the interrupt. TMCNT holds the number of instructions left.
+    class TimerDevice : public IDevice, public std::enable_shared_from_this<TimerDevice>
+    {
+    public:
+        TimerDevice(IDeviceScheduler & scheduler);
+        virtual ~TimerDevice(void) override = default;
+
+        virtual std::pair<uint16_t, PIMicroOp> read(uint16_t addr) override;
+        virtual uint16_t peek(uint16_t addr) const override;
+        virtual PIMicroOp write(uint16_t addr, uint16_t value) override;
+        virtual std::vector<uint16_t> getAddrMap(void) const override;
+        virtual std::string getName(void) const override { return "Timer"; }
+        virtual PIMicroOp tick(void) override;
+        virtual bool needsTick(void) const override { return false; }
+
+    private:
+        IDeviceScheduler & scheduler;
+
+        uint16_t control, reload, vector;
+        // Instruction count at which the timer expires next, while it is running.
+        uint64_t expiry;
+
+        bool isRunning(void) const { return (control & 0x0001) != 0 && reload != 0; }
+        void restart(void);
+    };
 };
 };
 
@@ -21,6 +21,10 @@ static constexpr uint16_t KBSR = 0xFE00;
 static constexpr uint16_t KBDR = 0xFE02;
 static constexpr uint16_t DSR = 0xFE04;
 static constexpr uint16_t DDR = 0xFE06;
+static constexpr uint16_t TMCR = 0xFE08;
+static constexpr uint16_t TMRR = 0xFE0A;
+static constexpr uint16_t TMVR = 0xFE0C;
+static constexpr uint16_t TMCNT = 0xFE0E;
 static constexpr uint16_t BSP = 0xFFFA;
 static constexpr uint16_t PSR = 0xFFFC;
 static constexpr uint16_t MCR = 0xFFFE;
@@ -10,14 +10,28 @@
 
 using namespace lc3::core::asmbl;
 
-Encoder::Encoder(lc3::utils::AssemblerLogger & logger, bool enable_liberal_asm)
-    : ISAHandler(), logger(logger), enable_liberal_asm(enable_liberal_asm)
+static std::map<std::string, std::vector<lc3::core::PIInstruction>> buildInstructionsByName(
+    std::vector<lc3::core::PIInstruction> const & instructions)
 {
-    for(PIInstruction inst : instructions) {
+    std::map<std::string, std::vector<lc3::core::PIInstruction>> instructions_by_name;
+    for(lc3::core::PIInstruction const & inst : instructions) {
         instructions_by_name[inst->getName()].push_back(inst);
     }
+    return instructions_by_name;
+}
+
+std::map<std::string, std::vector<lc3::core::PIInstruction>> const & Encoder::getInstructionsByName(void)
+{
+    static std::map<std::string, std::vector<PIInstruction>> const instructions_by_name =
+        buildInstructionsByName(createInstructions());
+    return instructions_by_name;
 }
 
+Encoder::Encoder(lc3::utils::AssemblerLogger & logger, bool enable_liberal_asm)
+    : ISAHandler(), logger(logger), enable_liberal_asm(enable_liberal_asm),
+      instructions_by_name(getInstructionsByName())
+{ }
+
 bool Encoder::isStringPseudo(std::string const & search) const
 {
     return search.size() > 0 && search[0] == '.';
@@ -81,7 +95,6 @@ bool Encoder::isValidPseudoFill(Statement const & statement, lc3::core::SymbolTa
             if(log_enable) {
                 logger.asmPrintf(PrintType::P_ERROR, statement, statement.operands[0],
                     "could not find label");
-                logger.newline();
             }
             return false;
         }
@@ -100,7 +113,6 @@ bool Encoder::isValidPseudoBlock(Statement const & statement, bool log_enable) c
                 if(log_enable && statement.operands[0].num == 0) {
                     logger.asmPrintf(utils::PrintType::P_ERROR, statement, statement.operands[0],
                         "operand to .blkw must be > 0");
-                    logger.newline();
                 }
                 return statement.operands[0].num != 0;
             }
@@ -146,11 +158,9 @@ bool Encoder::validatePseudo(Statement const & statement, lc3::core::SymbolTable
     } else {
         if(enable_liberal_asm) {
             logger.asmPrintf(PrintType::P_WARNING, statement, *statement.base, "ignoring invalid pseudo-op");
-            logger.newline(PrintType::P_WARNING);
             return true;
         } else {
             logger.asmPrintf(PrintType::P_ERROR, statement, *statement.base, "invalid pseudo-op");
-            logger.newline();
             return false;
         }
     }
@@ -166,7 +176,6 @@ bool Encoder::validatePseudoOperands(Statement const & statement, std::string co
         if(log_enable) {
             logger.asmPrintf(PrintType::P_ERROR, statement, "%s requires %d more operand(s)", pseudo.c_str(),
                 operand_count - statement.operands.size());
-            logger.newline();
         }
         return false;
     } else if(statement.operands.size() > operand_count) {
@@ -175,7 +184,6 @@ bool Encoder::validatePseudoOperands(Statement const & statement, std::string co
             for(uint32_t i = operand_count; i < statement.operands.size(); i += 1) {
                 logger.asmPrintf(PrintType::P_ERROR, statement, statement.operands[i], "extraneous operand to %s",
                     pseudo.c_str());
-                logger.newline();
             }
         }
         return false;
@@ -207,7 +215,6 @@ bool Encoder::validatePseudoOperands(Statement const & statement, std::string co
                     }
                     logger.asmPrintf(PrintType::P_ERROR, statement, statement.operands[i], "%s",
                         error_msg.str().c_str());
-                    logger.newline();
                 }
             }
         }
@@ -286,16 +293,15 @@ lc3::optional<lc3::core::PIInstruction> Encoder::validateInstruction(Statement c
             std::string const & candidate_inst_name = std::get<0>(candidate)->getName();
             if(candidate_inst_name != prev_candidate_inst_name) {
                 if(candidate_count < 3) {
-                    logger.printf(PrintType::P_NOTE, false, "did you mean \'%s\'?", candidate_inst_name.c_str());
+                    logger.asmNote("did you mean \'%s\'?", candidate_inst_name.c_str());
                     prev_candidate_inst_name = candidate_inst_name;
                 }
                 candidate_count += 1;
             }
         }
         if(candidate_count > 3) {
-            logger.printf(PrintType::P_NOTE, false, "...or %d other candidate(s) (not shown)", candidate_count - 3);
+            logger.asmNote("...or %d other candidate(s) (not shown)", candidate_count - 3);
         }
-        logger.newline();
         return {};
     }
 
@@ -308,16 +314,14 @@ lc3::optional<lc3::core::PIInstruction> Encoder::validateInstruction(Statement c
         for(Candidate const & candidate : candidates) {
             if(utils::toLower(statement.base->str) == std::get<0>(candidate)->getName()) {
                 if(candidate_count < 3) {
-                    logger.printf(PrintType::P_NOTE, false, "did you mean \'%s\'?",
-                        std::get<0>(candidate)->toFormatString().c_str());
+                    logger.asmNote("did you mean \'%s\'?", std::get<0>(candidate)->toFormatString().c_str());
                 }
                 candidate_count += 1;
             }
         }
         if(candidate_count > 3) {
-            logger.printf(PrintType::P_NOTE, false, "...or %d other candidate(s) (not shown)", candidate_count - 3);
+            logger.asmNote("...or %d other candidate(s) (not shown)", candidate_count - 3);
         }
-        logger.newline();
         return {};
     }
 
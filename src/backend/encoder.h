@@ -55,7 +55,10 @@ namespace asmbl
         bool validatePseudoOperands(Statement const & statement, std::string const & pseudo,
             std::vector<StatementPiece::Type> const & valid_types, uint32_t operand_count, bool log_enable) const;
 
-        std::map<std::string, std::vector<PIInstruction>> instructions_by_name;
+        // Encoding does not modify the instructions, so all encoders share them.
+        std::map<std::string, std::vector<PIInstruction>> const & instructions_by_name;
+
+        static std::map<std::string, std::vector<PIInstruction>> const & getInstructionsByName(void);
 
         uint32_t levDistance(std::string const & a, std::string const & b) const;
         uint32_t levDistanceHelper(std::string const & a, uint32_t a_len, std::string const & b, uint32_t b_len) const;
@@ -1,7 +1,9 @@
 /*
  * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
  */
+#include "device_regs.h"
 #include "event.h"
+#include "object_sink.h"
 #include "uop.h"
 #include "state.h"
 
@@ -29,6 +31,81 @@ std::string AtomicInstProcessEvent::toString(MachineState const & state) const
         std::get<0>(state.readMem(state.readPC())), state.getMemLine(state.readPC()).c_str());
 }
 
+void NativeTrapEvent::handleEvent(MachineState & state)
+{
+    uint16_t pc = state.readPC();
+    uint16_t vec = state.peekMem(pc) & 0x00FF;
+    std::shared_ptr<KeyboardDevice> keyboard = std::dynamic_pointer_cast<KeyboardDevice>(state.getDeviceReg(KBDR));
+    std::shared_ptr<DisplayDevice> display = std::dynamic_pointer_cast<DisplayDevice>(state.getDeviceReg(DDR));
+
+    std::string str;
+    bool native = keyboard != nullptr && display != nullptr && ! isAccessViolation(pc, state);
+    if(vec == 0x20 || vec == 0x23) {
+        native = native && utils::getBit(state.peekMem(KBSR), 15) == 1;
+    } else if(vec == 0x22 || vec == 0x24) {
+        native = native && readString(state, state.readReg(0), vec == 0x24, str);
+    }
+
+    if(! native) {
+        AtomicInstProcessEvent::handleEvent(state);
+        return;
+    }
+
+    state.writeIR(state.peekMem(pc));
+    state.writePC(pc + 1);
+    inst_charge = charge;
+
+    if(vec == 0x20 || vec == 0x23) {
+        // The OS polls KBSR before reading the key.
+        uops = state.readMem(KBSR).second;
+
+        uint16_t key = 0;
+        keyboard->takeKey(key);
+        state.writeReg(0, key);
+        if(vec == 0x23) {
+            display->writeString("\nInput a character> " + std::string(1, static_cast<char>(key)) + "\n");
+        }
+    } else if(vec == 0x21) {
+        display->writeString(std::string(1, static_cast<char>(state.readReg(0))));
+    } else if(vec == 0x22 || vec == 0x24) {
+        display->writeString(str);
+    } else if(vec == 0x25) {
+        display->writeString("\n\n--- Halting the LC-3 ---\n\n");
+        // The OS routine clears the clock enable bit of the MCR with R0 and R1.
+        state.writeReg(1, 0x7FFF);
+        state.writeReg(0, state.readMCR() & 0x7FFF);
+        state.writeMCR(state.readReg(0));
+        // Running again repeats the HALT, just as the OS routine does.
+        state.writePC(pc);
+    }
+}
+
+std::string NativeTrapEvent::toString(MachineState const & state) const
+{
+    return lc3::utils::ssprintf("Processing M[0x%0.4x]:0x%0.4x (%s) natively", state.readPC(),
+        state.peekMem(state.readPC()), state.getMemLine(state.readPC()).c_str());
+}
+
+bool NativeTrapEvent::readString(MachineState const & state, uint16_t addr, bool packed, std::string & str)
+{
+    // Strings that run into device registers are left to the OS, since reading them may have side effects.
+    for(uint32_t cur = addr; cur < MMIO_START; cur += 1) {
+        uint16_t value = state.peekMem(static_cast<uint16_t>(cur));
+        if(! packed) {
+            if(value == 0) { return true; }
+            str.push_back(static_cast<char>(value));
+        } else {
+            // Like the OS, stop at any NUL, even in the upper byte.
+            if((value & 0x00FF) == 0) { return true; }
+            str.push_back(static_cast<char>(value & 0x00FF));
+            if((value >> 8) == 0) { return true; }
+            str.push_back(static_cast<char>(value >> 8));
+        }
+    }
+
+    return false;
+}
+
 void SetupEvent::handleEvent(MachineState & state)
 {
     uint16_t reset_pc = state.readResetPC();
@@ -101,73 +178,8 @@ std::string ShutdownEvent::toString(MachineState const & state) const
 
 void LoadObjFileEvent::handleEvent(MachineState & state)
 {
-    using namespace lc3::utils;
-
-    uint32_t fill_pc = 0;
-    uint32_t offset = 0;
-    bool first_orig_set = false;
-
-    // Verify header.
-    std::string expected_header = lc3::utils::getMagicHeader();
-    char * header = new char[expected_header.size()];
-    if(buffer.read(header, expected_header.size())) {
-        for(uint32_t i = 0; i < expected_header.size(); i += 1) {
-            if(header[i] != expected_header[i]) {
-                logger.printf(PrintType::P_ERROR, true, "invalid header (is this a .obj file?); try re-assembling");
-                throw lc3::utils::exception("invalid header (is this a .obj file?); try re-assembling");
-            }
-        }
-        delete[] header;
-    } else {
-        delete[] header;
-        logger.printf(PrintType::P_ERROR, true, "could not read header");
-        throw lc3::utils::exception("could not read header");
-    }
-
-    // Verify version number matches current version number.
-    std::string expected_version = lc3::utils::getVersionString();
-    char * version = new char[expected_version.size()];
-    if(buffer.read(version, expected_version.size())) {
-        for(uint32_t i = 0; i < expected_version.size(); i += 1) {
-            if(version[i] != expected_version[i]) {
-                logger.printf(PrintType::P_ERROR, true, "mismatched version numbers; try re-assembling");
-                throw lc3::utils::exception("mismatched version numbers; try re-assembling");
-            }
-        }
-        delete[] version;
-    } else {
-        delete[] version;
-        logger.printf(PrintType::P_ERROR, true, "could not read version number; try re-assembling");
-        throw lc3::utils::exception("could not read version number; try re-assembling");
-    }
-
-    while(! buffer.eof()) {
-        MemLocation mem;
-        buffer >> mem;
-
-        if(buffer.eof()) {
-            break;
-        }
-
-        if(mem.isOrig()) {
-            if(! first_orig_set) {
-                if(mem.getValue() != 0) {
-                    // If orig is 0, then most likely an OS is being loaded.  Don't change the reset PC.
-                    state.writeResetPC(mem.getValue());
-                }
-                first_orig_set = true;
-            }
-            fill_pc = mem.getValue();
-            offset = 0;
-        } else {
-            logger.printf(lc3::utils::PrintType::P_DEBUG, true, "0x%0.4x: %s (0x%0.4x)", fill_pc + offset,
-                mem.getLine().c_str(), mem.getValue());
-            state.writeMem(fill_pc + offset, mem.getValue());
-            state.setMemLine(fill_pc + offset, mem.getLine());
-            offset += 1;
-        }
-
-    }
+    MachineStateSink sink(state, logger);
+    readObj(buffer, sink, logger);
 }
 
 std::string LoadObjFileEvent::toString(MachineState const & state) const
@@ -193,12 +205,12 @@ std::string DeviceUpdateEvent::toString(MachineState const & state) const
 
 void CheckForInterruptEvent::handleEvent(MachineState & state)
 {
-    InterruptType interrupt = state.peekInterrupt();
-    if(interrupt != InterruptType::INVALID &&
-        (getInterruptPriority(interrupt) > lc3::utils::getBits(state.readPSR(), 10, 8)))
+    Interrupt interrupt = state.peekInterrupt();
+    if(interrupt.type != InterruptType::INVALID &&
+        (interrupt.priority > lc3::utils::getBits(state.readPSR(), 10, 8)))
     {
         std::pair<PIMicroOp, PIMicroOp> handle_interrupt_chain = buildSystemModeEnter(INTEX_TABLE_START,
-            getInterruptVector(interrupt), getInterruptPriority(interrupt)
+            interrupt.vector, interrupt.priority
         );
         PIMicroOp dequeue_interrupt = std::make_shared<PopInterruptTypeMicroOp>();
         PIMicroOp callback = std::make_shared<CallbackMicroOp>(CallbackType::INT_ENTER);
@@ -214,11 +226,11 @@ void CheckForInterruptEvent::handleEvent(MachineState & state)
 
 std::string CheckForInterruptEvent::toString(MachineState const & state) const
 {
-    InterruptType interrupt = state.peekInterrupt();
-    if(interrupt != InterruptType::INVALID &&
-        (getInterruptPriority(interrupt) > lc3::utils::getBits(state.readPSR(), 10, 8)))
+    Interrupt interrupt = state.peekInterrupt();
+    if(interrupt.type != InterruptType::INVALID &&
+        (interrupt.priority > lc3::utils::getBits(state.readPSR(), 10, 8)))
     {
-        return lc3::utils::ssprintf("Handling %s interrupt", interruptTypeToString(interrupt).c_str());
+        return lc3::utils::ssprintf("Handling %s interrupt", interruptTypeToString(interrupt.type).c_str());
     } else {
         return "No interrupt of higher priority pending";
     }
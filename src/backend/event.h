@@ -49,6 +49,26 @@ namespace core
         sim::Decoder const & decoder;
     };
 
+    // Performs TRAP x20-x25 directly rather than running the OS routine, as if the routine had run and returned. A
+    // trap that can't complete immediately (i.e. GETC and IN before a key is pressed) is processed normally instead.
+    // inst_charge is set to the number of instructions the trap counts as.
+    class NativeTrapEvent : public AtomicInstProcessEvent
+    {
+    public:
+        NativeTrapEvent(uint64_t time, sim::Decoder const & decoder, uint64_t charge, uint64_t & inst_charge) :
+            AtomicInstProcessEvent(time, decoder), charge(charge), inst_charge(inst_charge)
+        { }
+
+        virtual void handleEvent(MachineState & state) override;
+        virtual std::string toString(MachineState const & state) const override;
+
+    private:
+        uint64_t charge;
+        uint64_t & inst_charge;
+
+        static bool readString(MachineState const & state, uint16_t addr, bool packed, std::string & str);
+    };
+
     class SetupEvent : public IEvent
     {
     public:
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#include <algorithm>
+#include <fstream>
+
+#include "framebuffer.h"
+
+constexpr uint16_t lc3::core::Framebuffer::START;
+constexpr uint16_t lc3::core::Framebuffer::WIDTH;
+constexpr uint16_t lc3::core::Framebuffer::HEIGHT;
+constexpr uint32_t lc3::core::Framebuffer::SIZE;
+
+lc3::core::Framebuffer::Framebuffer(void) : row_start(HEIGHT), row_end(HEIGHT)
+{
+    markAllDirty();
+}
+
+void lc3::core::Framebuffer::markAllDirty(void)
+{
+    std::fill(row_start.begin(), row_start.end(), 0);
+    std::fill(row_end.begin(), row_end.end(), WIDTH - 1);
+    dirty = true;
+}
+
+std::vector<lc3::core::FramebufferRect> lc3::core::Framebuffer::getAndClearDirtyRects(void)
+{
+    std::vector<FramebufferRect> rects;
+    if(! dirty) {
+        return rects;
+    }
+
+    uint16_t row = 0;
+    while(row < HEIGHT) {
+        if(row_start[row] > row_end[row]) {
+            row += 1;
+            continue;
+        }
+
+        uint16_t top = row, left = row_start[row], right = row_end[row];
+        while(row < HEIGHT && row_start[row] <= row_end[row]) {
+            left = std::min(left, row_start[row]);
+            right = std::max(right, row_end[row]);
+            row += 1;
+        }
+        rects.push_back({left, top, static_cast<uint16_t>(right - left + 1), static_cast<uint16_t>(row - top)});
+    }
+
+    clear();
+    return rects;
+}
+
+bool lc3::core::Framebuffer::writePPM(std::string const & filename, std::vector<uint16_t> const & pixels)
+{
+    std::ofstream file(filename, std::ios::binary);
+    if(! file) {
+        return false;
+    }
+
+    file << "P6\n" << WIDTH << " " << HEIGHT << "\n255\n";
+    std::vector<char> data;
+    data.reserve(SIZE * 3);
+    for(uint32_t i = 0; i < SIZE; i += 1) {
+        uint16_t pixel = i < pixels.size() ? pixels[i] : 0;
+        // Scale each 5-bit channel to 8 bits so that the brightest value is 255.
+        for(uint32_t shift : { 10, 5, 0 }) {
+            uint32_t channel = (pixel >> shift) & 0x1f;
+            data.push_back(static_cast<char>((channel << 3) | (channel >> 2)));
+        }
+    }
+    file.write(data.data(), data.size());
+    return static_cast<bool>(file);
+}
+
+void lc3::core::Framebuffer::clear(void)
+{
+    std::fill(row_start.begin(), row_start.end(), WIDTH);
+    std::fill(row_end.begin(), row_end.end(), 0);
+    dirty = false;
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#ifndef FRAMEBUFFER_H
+#define FRAMEBUFFER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace lc3
+{
+namespace core
+{
+    // Inclusive of (x, y) and spanning width columns and height rows of pixels.
+    struct FramebufferRect
+    {
+        uint16_t x, y, width, height;
+    };
+
+    // Tracks which pixels of the video memory at xC000-xFDFF were written. The video memory holds HEIGHT rows of
+    // WIDTH pixels, each of which is formatted as xRRRRRGGGGGBBBBB. The pixels themselves stay in memory; only the
+    // leftmost and rightmost modified column of each row are remembered, so tracking a store is a few comparisons.
+    class Framebuffer
+    {
+    public:
+        static constexpr uint16_t START = 0xC000;
+        static constexpr uint16_t WIDTH = 128;
+        static constexpr uint16_t HEIGHT = 124;
+        static constexpr uint32_t SIZE = WIDTH * HEIGHT;
+
+        Framebuffer(void);
+
+        static bool contains(uint16_t addr) { return addr >= START && static_cast<uint32_t>(addr - START) < SIZE; }
+        void markDirty(uint16_t addr)
+        {
+            uint16_t row = (addr - START) / WIDTH, col = (addr - START) % WIDTH;
+            if(col < row_start[row]) { row_start[row] = col; }
+            if(col > row_end[row]) { row_end[row] = col; }
+            dirty = true;
+        }
+        void markAllDirty(void);
+        bool isDirty(void) const { return dirty; }
+
+        // Modified pixels since the previous call. Consecutive modified rows are combined into a single rectangle
+        // covering all of their modified columns, so the rectangles may also include some unmodified pixels.
+        std::vector<FramebufferRect> getAndClearDirtyRects(void);
+
+        // Write SIZE pixels as a binary PPM image.
+        static bool writePPM(std::string const & filename, std::vector<uint16_t> const & pixels);
+
+    private:
+        // A row is clean when its start is greater than its end.
+        std::vector<uint16_t> row_start, row_end;
+        bool dirty;
+
+        void clear(void);
+    };
+};
+};
+
+#endif
@@ -0,0 +1,229 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#include <algorithm>
+#include <cstring>
+
+#include "device_regs.h"
+#include "history.h"
+
+lc3::core::History::History(uint64_t max_size, uint64_t checkpoint_interval) : position(0), undo_start(0),
+    device_event(false), next_checkpoint(0), pending()
+{
+    max_undo_size = max_size / 2;
+    max_checkpoints = std::max<uint64_t>((max_size - max_undo_size) / ((USER_END + 1) * sizeof(uint16_t)), 1);
+
+    // Re-executing from a checkpoint must leave every re-executed instruction in the undo log.
+    uint64_t max_interval = std::max<uint64_t>(max_undo_size / sizeof(UndoEntry), 1);
+    this->checkpoint_interval = std::max<uint64_t>(std::min(checkpoint_interval, max_interval), 1);
+}
+
+void lc3::core::History::begin(lc3::core::MachineState const & state, std::vector<uint16_t> const & stack_trace,
+    std::vector<lc3::core::MemWrite> const & mem_writes)
+{
+    // The MCR is written whenever the machine is started or suspended.
+    bool modified = checkpoints.empty() && entries.empty();
+    for(MemWrite const & write : mem_writes) {
+        if(write.addr != MCR && isUndoable(write.addr)) { modified = true; }
+    }
+
+    Registers cur = snapshot(state, stack_trace);
+    modified = modified || std::memcmp(cur.regs, pending.regs, sizeof(cur.regs)) != 0 || cur.pc != pending.pc ||
+        cur.ssp != pending.ssp || cur.func_trace_depth != pending.func_trace_depth ||
+        cur.stack_trace_depth != pending.stack_trace_depth;
+
+    if(modified) {
+        reset(state, stack_trace);
+    }
+}
+
+void lc3::core::History::recordInstruction(lc3::core::MachineState const & state,
+    std::vector<uint16_t> const & stack_trace, std::vector<lc3::core::MemWrite> const & mem_writes)
+{
+    uint32_t num_mem_writes = 0;
+    for(MemWrite const & write : mem_writes) {
+        if(isUndoable(write.addr)) {
+            mem_undos.push_back({write.addr, write.old_value});
+            num_mem_writes += 1;
+        } else if(write.addr != DDR) {
+            // Output is the only device write that leaves the device as re-executing the instruction would.
+            device_event = true;
+        }
+    }
+    entries.push_back({pending, num_mem_writes});
+
+    position += 1;
+    pending = snapshot(state, stack_trace);
+    if(device_event) {
+        checkpoints.clear();
+        device_event = false;
+        next_checkpoint = position + checkpoint_interval;
+    }
+    if(position >= next_checkpoint &&
+        (checkpoints.empty() || position - checkpoints.back().position >= checkpoint_interval))
+    {
+        takeCheckpoint(state, stack_trace);
+    }
+
+    trim();
+}
+
+uint64_t lc3::core::History::getOldestPosition(void) const
+{
+    if(checkpoints.empty()) {
+        return undo_start;
+    }
+    return std::min(undo_start, checkpoints.front().position);
+}
+
+bool lc3::core::History::undo(lc3::core::MachineState & state, std::vector<uint16_t> & stack_trace)
+{
+    if(entries.empty()) {
+        return false;
+    }
+
+    // Restore memory in the reverse order it was written in, in case a location was written more than once.
+    UndoEntry const & entry = entries.back();
+    for(uint32_t i = 0; i < entry.num_mem_writes; i += 1) {
+        state.writeMem(mem_undos.back().addr, mem_undos.back().value);
+        mem_undos.pop_back();
+    }
+    restoreRegisters(entry.before, state, stack_trace);
+    pending = entry.before;
+    entries.pop_back();
+
+    position -= 1;
+    while(! checkpoints.empty() && checkpoints.back().position > position) {
+        checkpoints.pop_back();
+    }
+    return true;
+}
+
+bool lc3::core::History::restoreCheckpoint(uint64_t target, lc3::core::MachineState & state,
+    std::vector<uint16_t> & stack_trace)
+{
+    while(! checkpoints.empty() && checkpoints.back().position > target) {
+        checkpoints.pop_back();
+    }
+    if(checkpoints.empty()) {
+        return false;
+    }
+
+    // Only write the locations that differ, so that the restore doesn't mark all of memory as modified.
+    Checkpoint const & checkpoint = checkpoints.back();
+    for(uint32_t addr = 0; addr < checkpoint.mem.size(); addr += 1) {
+        if(state.peekMem(static_cast<uint16_t>(addr)) != checkpoint.mem[addr]) {
+            state.writeMem(static_cast<uint16_t>(addr), checkpoint.mem[addr]);
+        }
+    }
+    for(uint16_t i = 0; i < 8; i += 1) {
+        state.writeReg(i, checkpoint.regs[i]);
+    }
+    state.writePC(checkpoint.pc);
+    state.writeIR(checkpoint.ir);
+    state.writeSSP(checkpoint.ssp);
+    state.writePSR(checkpoint.psr);
+    state.writeMCR(checkpoint.mcr);
+    state.setFuncTrace(checkpoint.func_trace);
+    stack_trace = checkpoint.stack_trace;
+
+    position = checkpoint.position;
+    undo_start = position;
+    pending = snapshot(state, stack_trace);
+    entries.clear();
+    mem_undos.clear();
+    return true;
+}
+
+void lc3::core::History::reset(lc3::core::MachineState const & state, std::vector<uint16_t> const & stack_trace)
+{
+    undo_start = position;
+    device_event = false;
+    next_checkpoint = position;
+    pending = snapshot(state, stack_trace);
+    entries.clear();
+    mem_undos.clear();
+    checkpoints.clear();
+    takeCheckpoint(state, stack_trace);
+}
+
+void lc3::core::History::takeCheckpoint(lc3::core::MachineState const & state,
+    std::vector<uint16_t> const & stack_trace)
+{
+    checkpoints.emplace_back();
+    Checkpoint & checkpoint = checkpoints.back();
+    checkpoint.position = position;
+    checkpoint.mem.resize(USER_END + 1);
+    for(uint32_t addr = 0; addr < checkpoint.mem.size(); addr += 1) {
+        checkpoint.mem[addr] = state.peekMem(static_cast<uint16_t>(addr));
+    }
+    for(uint16_t i = 0; i < 8; i += 1) {
+        checkpoint.regs[i] = state.readReg(i);
+    }
+    checkpoint.pc = state.readPC();
+    checkpoint.ir = state.readIR();
+    checkpoint.ssp = state.readSSP();
+    checkpoint.psr = state.readPSR();
+    checkpoint.mcr = state.readMCR();
+    checkpoint.func_trace = state.getFuncTrace();
+    checkpoint.stack_trace = stack_trace;
+}
+
+void lc3::core::History::trim(void)
+{
+    while(entries.size() > 1 &&
+        entries.size() * sizeof(UndoEntry) + mem_undos.size() * sizeof(MemUndo) > max_undo_size)
+    {
+        for(uint32_t i = 0; i < entries.front().num_mem_writes; i += 1) {
+            mem_undos.pop_front();
+        }
+        entries.pop_front();
+        undo_start += 1;
+    }
+
+    while(checkpoints.size() > max_checkpoints) {
+        checkpoints.pop_front();
+    }
+}
+
+void lc3::core::History::restoreRegisters(lc3::core::History::Registers const & regs,
+    lc3::core::MachineState & state, std::vector<uint16_t> & stack_trace) const
+{
+    for(uint16_t i = 0; i < 8; i += 1) {
+        state.writeReg(i, regs.regs[i]);
+    }
+    state.writePC(regs.pc);
+    state.writeIR(regs.ir);
+    state.writeSSP(regs.ssp);
+
+    // An instruction pushes or pops at most one entry, so the innermost entry is the only one that may be missing.
+    std::vector<FuncType> func_trace = state.getFuncTrace();
+    func_trace.resize(regs.func_trace_depth, regs.func_trace_top);
+    state.setFuncTrace(func_trace);
+    stack_trace.resize(regs.stack_trace_depth, regs.stack_trace_top);
+}
+
+lc3::core::History::Registers lc3::core::History::snapshot(lc3::core::MachineState const & state,
+    std::vector<uint16_t> const & stack_trace)
+{
+    Registers ret;
+    for(uint16_t i = 0; i < 8; i += 1) {
+        ret.regs[i] = state.readReg(i);
+    }
+    ret.pc = state.readPC();
+    ret.ir = state.readIR();
+    ret.ssp = state.readSSP();
+
+    std::vector<FuncType> const & func_trace = state.getFuncTrace();
+    ret.func_trace_depth = static_cast<uint32_t>(func_trace.size());
+    ret.func_trace_top = func_trace.empty() ? FuncType::INVALID : func_trace.back();
+    ret.stack_trace_depth = static_cast<uint32_t>(stack_trace.size());
+    ret.stack_trace_top = stack_trace.empty() ? 0 : stack_trace.back();
+    return ret;
+}
+
+bool lc3::core::History::isUndoable(uint16_t addr)
+{
+    // Writes to other device registers have side effects, and devices are not rolled back anyway.
+    return addr < MMIO_START || addr == PSR || addr == MCR;
+}
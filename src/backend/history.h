@@ -0,0 +1,119 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "func_type.h"
+#include "state.h"
+
+#ifndef DEFAULT_HISTORY_SIZE
+    #define DEFAULT_HISTORY_SIZE (64 * 1024 * 1024)
+#endif
+
+#ifndef DEFAULT_HISTORY_CHECKPOINT_INTERVAL
+    #define DEFAULT_HISTORY_CHECKPOINT_INTERVAL 100000
+#endif
+
+namespace lc3
+{
+namespace core
+{
+    // Remembers executed instructions so that they can be undone. Each instruction adds an entry to an undo log that
+    // holds the registers before the instruction and the previous value of everything it wrote to memory, so recent
+    // instructions are undone one at a time. A full copy of the machine is also taken every checkpoint_interval
+    // instructions, from which older instructions are reached by restoring the checkpoint and re-executing forward.
+    // Half of max_size is used for the undo log and half for checkpoints; the oldest of each is discarded first.
+    //
+    // Positions count the instructions recorded since the history was created, and the state at position N is the
+    // state after N instructions. Device state (e.g. consumed input and printed output) is never undone, and
+    // checkpoints do not hold it, so re-executing past a device event (e.g. input being delivered, a timer expiring, or
+    // the program writing a device register) would not reproduce the original run. Checkpoints taken before the most
+    // recent device event are therefore discarded, and such instructions can only be undone from the undo log.
+    class History
+    {
+    public:
+        History(uint64_t max_size, uint64_t checkpoint_interval);
+
+        // Called at the start of each run. If the machine was modified since the previous run (other than by
+        // undoing instructions), the history can no longer reproduce it, so the history is discarded.
+        void begin(MachineState const & state, std::vector<uint16_t> const & stack_trace,
+            std::vector<MemWrite> const & mem_writes);
+        void recordInstruction(MachineState const & state, std::vector<uint16_t> const & stack_trace,
+            std::vector<MemWrite> const & mem_writes);
+        // Something outside of the machine changed a device during the instruction that is being executed.
+        void markDeviceEvent(void) { device_event = true; }
+
+        uint64_t getPosition(void) const { return position; }
+        // The oldest position that can be returned to.
+        uint64_t getOldestPosition(void) const;
+        // Instructions after this position can be undone without re-executing anything.
+        uint64_t getUndoStart(void) const { return undo_start; }
+
+        // Undo the most recent instruction. Returns false if the undo log is empty.
+        bool undo(MachineState & state, std::vector<uint16_t> & stack_trace);
+        // Restore the most recent checkpoint at or before target and discard everything after it. Returns false if
+        // there is no such checkpoint.
+        bool restoreCheckpoint(uint64_t target, MachineState & state, std::vector<uint16_t> & stack_trace);
+
+    private:
+        struct Registers
+        {
+            uint16_t regs[8];
+            uint16_t pc, ir, ssp;
+            // Only the depth and innermost entry of each trace are kept, which is enough to undo a single call or
+            // return.
+            uint32_t func_trace_depth, stack_trace_depth;
+            FuncType func_trace_top;
+            uint16_t stack_trace_top;
+        };
+
+        struct UndoEntry
+        {
+            Registers before;
+            uint32_t num_mem_writes;
+        };
+
+        struct MemUndo
+        {
+            uint16_t addr;
+            uint16_t value;
+        };
+
+        struct Checkpoint
+        {
+            uint64_t position;
+            std::vector<uint16_t> mem;
+            uint16_t regs[8];
+            uint16_t pc, ir, ssp, psr, mcr;
+            std::vector<FuncType> func_trace;
+            std::vector<uint16_t> stack_trace;
+        };
+
+        uint64_t max_undo_size, max_checkpoints;
+        uint64_t checkpoint_interval;
+
+        uint64_t position, undo_start;
+        bool device_event;
+        // No checkpoint is taken before this position, so that device events don't each copy the whole machine.
+        uint64_t next_checkpoint;
+        Registers pending;
+        std::deque<UndoEntry> entries;
+        std::deque<MemUndo> mem_undos;
+        std::deque<Checkpoint> checkpoints;
+
+        void reset(MachineState const & state, std::vector<uint16_t> const & stack_trace);
+        void takeCheckpoint(MachineState const & state, std::vector<uint16_t> const & stack_trace);
+        void trim(void);
+        void restoreRegisters(Registers const & regs, MachineState & state, std::vector<uint16_t> & stack_trace) const;
+        static Registers snapshot(MachineState const & state, std::vector<uint16_t> const & stack_trace);
+        static bool isUndoable(uint16_t addr);
+    };
+};
+};
+
+#endif
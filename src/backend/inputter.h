@@ -4,6 +4,8 @@
 #ifndef INPUTTER_H
 #define INPUTTER_H
 
+#include <cstdint>
+
 namespace lc3
 {
 namespace utils
@@ -18,6 +20,11 @@ namespace utils
         virtual bool getChar(char & c) = 0;
         virtual void endInput(void) = 0;
         virtual bool hasRemaining(void) const = 0;
+        // Number of upcoming calls to getChar that are certain to return false, which lets the simulator skip over
+        // loops that wait for input. Inputters that cannot tell return 0.
+        virtual uint64_t getIdleCount(void) const { return 0; }
+        // Account for count calls to getChar that were skipped, all of which would have returned false.
+        virtual void skipIdle(uint64_t) {}
     };
 
     class NullInputter : public IInputter
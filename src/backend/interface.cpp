@@ -1,9 +1,12 @@
 /*
  * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
  */
+#include <algorithm>
 #include <cassert>
 #include <chrono>
 #include <fstream>
+#include <iterator>
+#include <sstream>
 #include <string>
 #include <random>
 
@@ -12,7 +15,8 @@
 #include "lc3os.h"
 
 lc3::sim::sim(lc3::utils::IPrinter & printer, lc3::utils::IInputter & inputter, uint32_t print_level) :
-    printer(printer), inputter(inputter), simulator(printer, inputter, print_level)
+    printer(printer), inputter(inputter), progress_printer(printer), simulator(progress_printer, inputter, print_level),
+    progress_queue(PROGRESS_QUEUE_SIZE), progress_held(false)
 {
     loadOS();
 
@@ -33,6 +37,12 @@ lc3::sim::sim(lc3::utils::IPrinter & printer, lc3::utils::IInputter & inputter,
     cur_inst_exec_limit = 0;
     target_inst_exec = 0;
     cur_sub_depth = 0;
+
+    progress_enabled = false;
+    progress_inst_interval = 0;
+    next_progress_inst = 0;
+    progress_time_interval = std::chrono::milliseconds(0);
+    progress_modified_ranges = false;
 }
 
 bool lc3::sim::loadObjFile(std::string const & filename)
@@ -57,6 +67,12 @@ bool lc3::sim::loadObjFile(std::string const & filename)
     return true;
 }
 
+void lc3::sim::loadObj(core::ObjectMemorySink const & obj)
+{
+    core::SimulatorSink sink(simulator);
+    obj.replay(sink);
+}
+
 void lc3::sim::setup(void)
 {
     simulator.setup();
@@ -148,7 +164,14 @@ lc3::core::MachineState & lc3::sim::getMachineState(void) { return simulator.get
 lc3::core::MachineState const & lc3::sim::getMachineState(void) const { return simulator.getMachineState(); }
 
 uint16_t lc3::sim::readReg(uint16_t id) const { return simulator.getMachineState().readReg(id); }
-uint16_t lc3::sim::readMem(uint16_t addr) const { return simulator.getMachineState().readMem(addr).first; }
+uint16_t lc3::sim::readMem(uint16_t addr) const { return simulator.getMachineState().peekMem(addr); }
+void lc3::sim::readMemRange(uint16_t start, uint32_t count, uint16_t * values) const
+{
+    core::MachineState const & state = simulator.getMachineState();
+    for(uint32_t i = 0; i < count; i += 1) {
+        values[i] = state.peekMem(static_cast<uint16_t>(start + i));
+    }
+}
 std::string lc3::sim::getMemLine(uint16_t addr) const { return simulator.getMachineState().getMemLine(addr); }
 uint16_t lc3::sim::readPC(void) const { return simulator.getMachineState().readPC(); }
 uint16_t lc3::sim::readPSR(void) const { return simulator.getMachineState().readPSR(); }
@@ -183,10 +206,178 @@ void lc3::sim::writeCC(char value)
     simulator.getMachineState().writePSR((readPSR() & 0x7FF8) | bits);
 }
 
+std::vector<std::pair<uint16_t, uint16_t>> lc3::sim::getAndClearModifiedRanges(void)
+{
+    return simulator.getMachineState().getAndClearDirtyRanges();
+}
+
+void lc3::sim::setProgressUpdates(uint64_t inst_interval, uint32_t time_interval_ms, bool include_output,
+    bool include_modified_ranges)
+{
+    progress_enabled = inst_interval != 0 || time_interval_ms != 0;
+    progress_inst_interval = inst_interval;
+    next_progress_inst = total_inst_exec + inst_interval;
+    progress_time_interval = std::chrono::milliseconds(time_interval_ms);
+    next_progress_time = std::chrono::steady_clock::now() + progress_time_interval;
+    progress_modified_ranges = progress_enabled && include_modified_ranges;
+
+    // Hand anything that was collected but never published back to the printer.
+    if(progress_printer.buffer.size() != 0) {
+        printer.print(progress_printer.buffer);
+        progress_printer.buffer.clear();
+    }
+    progress_printer.capture = progress_enabled && include_output;
+    progress_printer.limiter.reset();
+}
+
+bool lc3::sim::getProgressUpdate(lc3::SimProgress & progress)
+{
+    if(progress_queue.pop(progress)) {
+        return true;
+    }
+    if(! progress_held.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    // Nothing is pushed while an update is held back, but the queue may have filled up again just before it was.
+    std::lock_guard<std::mutex> lock(progress_held_mutex);
+    if(progress_queue.pop(progress)) {
+        return true;
+    }
+    progress = std::move(progress_held_update);
+    progress_held_update = SimProgress();
+    progress_held.store(false, std::memory_order_release);
+    return true;
+}
+
+void lc3::sim::setEnableProfiler(bool enable) { simulator.setEnableProfiler(enable); }
+
+void lc3::sim::resetProfiler(void)
+{
+    core::Profiler * profiler = simulator.getProfiler();
+    if(profiler != nullptr) {
+        profiler->reset();
+    }
+}
+
+uint64_t lc3::sim::getAddrExecCount(uint16_t addr) const
+{
+    core::Profiler const * profiler = simulator.getProfiler();
+    return profiler != nullptr ? profiler->getAddrCount(addr) : 0;
+}
+
+uint64_t lc3::sim::getOpcodeExecCount(uint16_t opcode) const
+{
+    core::Profiler const * profiler = simulator.getProfiler();
+    return profiler != nullptr ? profiler->getOpcodeCount(opcode) : 0;
+}
+
+std::vector<lc3::core::SubroutineProfile> lc3::sim::getSubroutineProfiles(void) const
+{
+    core::Profiler const * profiler = simulator.getProfiler();
+    return profiler != nullptr ? profiler->getSubroutineProfiles() : std::vector<core::SubroutineProfile>();
+}
+
+std::string lc3::sim::getProfileJSON(void) const
+{
+    core::Profiler const * profiler = simulator.getProfiler();
+    return profiler != nullptr ? profiler->toJSON() : "";
+}
+
+std::string lc3::sim::getProfileFoldedStacks(void) const
+{
+    core::Profiler const * profiler = simulator.getProfiler();
+    return profiler != nullptr ? profiler->toFoldedStacks() : "";
+}
+
+void lc3::sim::setEnableNativeTraps(bool enable, uint64_t inst_charge)
+{
+    simulator.setEnableNativeTraps(enable, inst_charge);
+}
+
+void lc3::sim::setEnablePollSkipping(bool enable) { simulator.setEnablePollSkipping(enable); }
+
+void lc3::sim::setEnableFramebuffer(bool enable) { simulator.setEnableFramebuffer(enable); }
+
+std::vector<lc3::core::FramebufferRect> lc3::sim::getAndClearFramebufferDirtyRects(void)
+{
+    core::Framebuffer * framebuffer = simulator.getFramebuffer();
+    if(framebuffer == nullptr) {
+        return {};
+    }
+    return framebuffer->getAndClearDirtyRects();
+}
+
+bool lc3::sim::writeFramebufferPPM(std::string const & filename) const
+{
+    std::vector<uint16_t> pixels(core::Framebuffer::SIZE);
+    readMemRange(core::Framebuffer::START, core::Framebuffer::SIZE, pixels.data());
+    return core::Framebuffer::writePPM(filename, pixels);
+}
+
+bool lc3::sim::registerDevice(lc3::core::PIDevice device) { return simulator.registerDevice(device); }
+lc3::core::IDeviceScheduler & lc3::sim::getDeviceScheduler(void) { return simulator; }
+
+bool lc3::sim::startTrace(std::string const & filename) { return simulator.startTrace(filename); }
+void lc3::sim::stopTrace(void) { simulator.stopTrace(); }
+
+void lc3::sim::setEnableReverse(bool enable, uint64_t max_size, uint64_t checkpoint_interval)
+{
+    simulator.setEnableHistory(enable, max_size, checkpoint_interval);
+}
+
+bool lc3::sim::stepBack(uint64_t count)
+{
+    uint64_t undone = 0;
+    try {
+        undone = simulator.stepBack(count);
+    } catch(utils::exception const & e) {
+#ifdef _ENABLE_DEBUG
+        printer.print("caught exception: " + std::string(e.what()));
+        printer.newline();
+#else
+        (void) e;
+#endif
+    }
+    total_inst_exec -= std::min(undone, total_inst_exec);
+    return undone == count;
+}
+
+bool lc3::sim::reverseContinue(void)
+{
+    uint64_t undone = 0;
+    try {
+        undone = simulator.reverseContinue();
+    } catch(utils::exception const & e) {
+#ifdef _ENABLE_DEBUG
+        printer.print("caught exception: " + std::string(e.what()));
+        printer.newline();
+#else
+        (void) e;
+#endif
+    }
+    total_inst_exec -= std::min(undone, total_inst_exec);
+    return undone != 0 && simulator.hasBreakpoint(readPC());
+}
+
 void lc3::sim::setBreakpoint(uint16_t addr) { simulator.addBreakpoint(addr); }
 void lc3::sim::removeBreakpoint(uint16_t addr) { simulator.removeBreakpoint(addr); }
 
-bool lc3::sim::didExceedInstLimit(void) const { return total_inst_exec == target_inst_exec; }
+bool lc3::sim::didExceedInstLimit(void) const
+{
+    return total_inst_exec == target_inst_exec || (cur_inst_exec_limit != 0 && simulator.didDetectLoop());
+}
+
+void lc3::sim::setEnableLoopDetection(bool enable, uint64_t interval)
+{
+    simulator.setEnableLoopDetection(enable, interval);
+}
+
+void lc3::sim::setOutputLimit(uint64_t limit, bool stop_on_exceed)
+{
+    progress_printer.setOutputLimit(limit);
+    simulator.setStopOnOutputLimit(stop_on_exceed);
+}
 
 void lc3::sim::registerCallback(lc3::core::CallbackType type, lc3::sim::Callback func) { callbacks[type] = func; }
 
@@ -199,30 +390,41 @@ void lc3::sim::setIgnorePrivilege(bool ignore_privilege) { simulator.setIgnorePr
 
 uint64_t lc3::sim::getInstExecCount(void) const { return total_inst_exec; }
 
-void lc3::sim::loadOS(void)
+static lc3::core::ObjectMemorySink assembleOS(lc3::utils::IPrinter & printer)
 {
-    core::Assembler assembler(printer, 0, false);
+    lc3::core::Assembler assembler(printer, 0, false);
     assembler.setFilename("lc3os");
 
     std::stringstream src_buffer;
     src_buffer << lc3::core::getOSSrc();
-    std::pair<std::shared_ptr<std::stringstream>, core::SymbolTable> asm_res;
+    lc3::core::ObjectMemorySink obj;
     try {
-        asm_res = assembler.assemble(src_buffer);
-    } catch(utils::exception const & e) {
+        assembler.assemble(src_buffer, obj);
+    } catch(lc3::utils::exception const & e) {
 #ifdef _ENABLE_DEBUG
         printer.print("caught exception: " + std::string(e.what()));
         printer.newline();
+#else
+        (void) e;
 #endif
-        return;
     }
-    simulator.loadObj("lc3os", *(asm_res.first));
+    return obj;
+}
+
+void lc3::sim::loadOS(void)
+{
+    // The OS never changes, so it is only assembled once.
+    static core::ObjectMemorySink const os_obj = assembleOS(printer);
+    loadObj(os_obj);
+    simulator.recordOSTraps();
 }
 
 bool lc3::sim::runHelper(void)
 {
     encountered_lc3_exception = false;
     target_inst_exec = total_inst_exec + cur_inst_exec_limit;
+    // Stepping over an instruction stops right after it, so nothing may be skipped past it.
+    simulator.setRunInstLimit(run_type == RunType::UNTIL_DEPTH && cur_sub_depth == 0 ? 1 : cur_inst_exec_limit);
 
 #ifdef _ENABLE_DEBUG
     auto start = std::chrono::high_resolution_clock::now();
@@ -235,9 +437,15 @@ bool lc3::sim::runHelper(void)
         printer.print("caught exception: " + std::string(e.what()));
         printer.newline();
 #endif
+        progress_printer.flush();
+        if(progress_enabled) { publishProgress(true); }
         return false;
     }
 
+    // Everything the program printed is visible once the run stops, e.g. at a HALT or a breakpoint.
+    progress_printer.flush();
+    if(progress_enabled) { publishProgress(true); }
+
 #ifdef _ENABLE_DEBUG
     auto end = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double> elapsed = end - start;
@@ -250,18 +458,76 @@ bool lc3::sim::runHelper(void)
     return ! encountered_lc3_exception;
 }
 
+void lc3::sim::publishProgress(bool finished)
+{
+    bool held = false;
+    if(progress_held.load(std::memory_order_acquire) || progress_queue.full()) {
+        // Leave the output and modified memory in place for the next update if the consumer has fallen behind, but
+        // hold on to the update that ends the run so that the consumer always finds out.
+        if(! finished) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(progress_held_mutex);
+        held = progress_held.load(std::memory_order_relaxed) || progress_queue.full();
+        if(held) {
+            collectProgress(progress_held_update, finished);
+            progress_held.store(true, std::memory_order_release);
+        }
+    }
+
+    if(! held) {
+        SimProgress progress;
+        collectProgress(progress, finished);
+        progress_queue.push(std::move(progress));
+    }
+
+    next_progress_inst = total_inst_exec + progress_inst_interval;
+    if(progress_time_interval.count() != 0) {
+        next_progress_time = std::chrono::steady_clock::now() + progress_time_interval;
+    }
+}
+
+void lc3::sim::collectProgress(lc3::SimProgress & progress, bool finished)
+{
+    core::MachineState & state = simulator.getMachineState();
+    progress.inst_exec_count = total_inst_exec;
+    progress.pc = state.readPC();
+    if(progress.output.empty()) {
+        progress.output.swap(progress_printer.buffer);
+    } else {
+        progress.output.append(progress_printer.buffer);
+        progress_printer.buffer.clear();
+    }
+    if(progress_modified_ranges) {
+        std::vector<std::pair<uint16_t, uint16_t>> ranges = state.getAndClearDirtyRanges();
+        progress.modified_ranges.insert(progress.modified_ranges.end(), ranges.begin(), ranges.end());
+    }
+    progress.finished = finished;
+}
+
 void lc3::sim::callbackDispatcher(lc3::sim * sim_inst, lc3::core::CallbackType type, lc3::core::MachineState & state)
 {
     using namespace lc3::core;
 
+    // Make sure that the output is visible while the program waits for input, or is stopped at a breakpoint, before
+    // anything else is done about it.
+    if(type == CallbackType::INPUT_POLL || type == CallbackType::INPUT_REQUEST || type == CallbackType::BREAKPOINT) {
+        sim_inst->progress_printer.flush();
+    }
+
     if(type == CallbackType::PRE_INST) {
         if(sim_inst->run_type == RunType::UNTIL_HALT && state.readMem(state.readPC()).first == 0xf025) {
             // Halt if current instruction is HALT.
             sim_inst->simulator.triggerSuspend();
         }
     } else if(type == CallbackType::POST_INST) {
-        // Increment total instruction count
-        ++(sim_inst->total_inst_exec);
+        // Increment total instruction count, without going past the instruction limit.
+        uint64_t inst_charge = sim_inst->simulator.getInstCharge();
+        if(sim_inst->cur_inst_exec_limit != 0) {
+            inst_charge = std::min(inst_charge, sim_inst->target_inst_exec - sim_inst->total_inst_exec);
+        }
+        sim_inst->total_inst_exec += inst_charge;
         if(sim_inst->cur_inst_exec_limit != 0) {
             if(sim_inst->total_inst_exec == sim_inst->target_inst_exec) {
                 // If an instruction limit is set (i.e. cur_inst_exec_limit != 0), halt when target is reached.
@@ -274,6 +540,17 @@ void lc3::sim::callbackDispatcher(lc3::sim * sim_inst, lc3::core::CallbackType t
                 sim_inst->simulator.triggerSuspend();
             }
         }
+
+        if(sim_inst->progress_enabled) {
+            if(sim_inst->progress_inst_interval != 0 && sim_inst->total_inst_exec >= sim_inst->next_progress_inst) {
+                sim_inst->publishProgress(false);
+            } else if(sim_inst->progress_time_interval.count() != 0 && (sim_inst->total_inst_exec & 0x3ff) == 0 &&
+                std::chrono::steady_clock::now() >= sim_inst->next_progress_time)
+            {
+                // Reading the clock is comparatively expensive, so it is only checked every 1024 instructions.
+                sim_inst->publishProgress(false);
+            }
+        }
     } else if(type == CallbackType::SUB_ENTER) {
         ++(sim_inst->cur_sub_depth);
     } else if(type == CallbackType::SUB_EXIT) {
@@ -306,8 +583,35 @@ void lc3::sim::callbackDispatcher(lc3::sim * sim_inst, lc3::core::CallbackType t
     }
 }
 
+void lc3::sim::ProgressPrinter::print(std::string const & string)
+{
+    if(capture) {
+        collect(string);
+    } else {
+        printer.print(string);
+    }
+}
+
+void lc3::sim::ProgressPrinter::newline(void)
+{
+    if(capture) {
+        collect("\n");
+    } else {
+        printer.newline();
+    }
+}
+
+void lc3::sim::ProgressPrinter::collect(std::string const & string)
+{
+    bool add_marker;
+    buffer.append(string, 0, limiter.fit(string.size(), add_marker));
+    if(add_marker) {
+        buffer += DEFAULT_OUTPUT_LIMIT_MARKER;
+    }
+}
+
 lc3::as::as(utils::IPrinter & printer, uint32_t print_level, bool enable_liberal_asm) :
-    printer(printer), assembler(printer, print_level, enable_liberal_asm)
+    printer(printer), assembler(printer, print_level, enable_liberal_asm), enable_incremental_asm(false)
 { }
 
 lc3::optional<std::pair<std::string, lc3::core::SymbolTable>> lc3::as::assemble(std::string const & asm_filename)
@@ -324,14 +628,69 @@ lc3::optional<std::pair<std::string, lc3::core::SymbolTable>> lc3::as::assemble(
     printer.print("attempting to assemble " + asm_filename + " into " + obj_filename);
     printer.newline();
 
-    std::pair<std::shared_ptr<std::stringstream>, core::SymbolTable> asm_res;
+    core::ObjectFileSink sink(obj_filename);
+    optional<core::SymbolTable> symbols = assembleHelper(asm_filename, in_file, sink);
+    if(! symbols) {
+        return {};
+    }
+
+    if(! sink.good()) {
+        printer.print("could not open " + obj_filename + " for writing");
+        printer.newline();
+        return {};
+    }
+
+    return std::make_pair(obj_filename, *symbols);
+}
+
+lc3::optional<lc3::core::SymbolTable> lc3::as::assemble(std::string const & asm_filename, core::IObjectSink & sink)
+{
+    assembler.setFilename(asm_filename);
+    std::ifstream in_file(asm_filename);
+    if(! in_file.is_open()) {
+        printer.print("could not open file " + asm_filename);
+        printer.newline();
+        return {};
+    }
+
+    printer.print("attempting to assemble " + asm_filename);
+    printer.newline();
+
+    return assembleHelper(asm_filename, in_file, sink);
+}
+
+lc3::optional<lc3::core::SymbolTable> lc3::as::assembleHelper(std::string const & asm_filename,
+    std::istream & in_file, core::IObjectSink & sink)
+{
+    core::SymbolTable symbols;
 
 #ifdef _ENABLE_DEBUG
     auto start = std::chrono::high_resolution_clock::now();
 #endif
 
+    bool cache_hit = false;
     try {
-        asm_res = assembler.assemble(in_file);
+        if(cache) {
+            std::string source((std::istreambuf_iterator<char>(in_file)), std::istreambuf_iterator<char>());
+            optional<core::SymbolTable> cached_symbols = cache->lookup(source, assembler.getLiberalAsm(), sink);
+            if(cached_symbols) {
+                assembler.clearDiagnostics();
+                symbols = *cached_symbols;
+                cache_hit = true;
+            } else {
+                std::istringstream source_buffer(source);
+                core::ObjectMemorySink obj;
+                symbols = assembleStream(asm_filename, source_buffer, obj);
+                // A cache hit cannot reproduce warnings or notice changes to included files, so only clean
+                // assemblies of self-contained files are cached.
+                if(assembler.getDiagnostics().empty() && assembler.getIncludedFiles().empty()) {
+                    cache->store(source, assembler.getLiberalAsm(), obj, symbols);
+                }
+                obj.replay(sink);
+            }
+        } else {
+            symbols = assembleStream(asm_filename, in_file, sink);
+        }
     } catch(utils::exception const & e) {
 #ifdef _ENABLE_DEBUG
         printer.print("caught exception: " + std::string(e.what()));
@@ -348,21 +707,19 @@ lc3::optional<std::pair<std::string, lc3::core::SymbolTable>> lc3::as::assemble(
     printer.newline();
 #endif
 
-    printer.print("assembly successful");
+    printer.print(cache_hit ? "assembly successful (cached)" : "assembly successful");
     printer.newline();
-    in_file.close();
 
-    std::ofstream out_file(obj_filename, std::ios_base::binary);
-    if(! out_file.is_open()) {
-        printer.print("could not open " + obj_filename + " for writing");
-        printer.newline();
-        return {};
-    }
-
-    out_file << (asm_res.first)->rdbuf();
-    out_file.close();
+    return symbols;
+}
 
-    return std::make_pair(obj_filename, asm_res.second);
+lc3::core::SymbolTable lc3::as::assembleStream(std::string const & asm_filename, std::istream & in_file,
+    core::IObjectSink & sink)
+{
+    if(enable_incremental_asm) {
+        return assembler.assemble(in_file, sessions[asm_filename], sink);
+    }
+    return assembler.assemble(in_file, sink);
 }
 
 lc3::conv::conv(utils::IPrinter & printer, uint32_t print_level) :
@@ -424,3 +781,20 @@ lc3::optional<std::string> lc3::conv::convertBin(std::string const & bin_filenam
 }
 
 void lc3::as::setEnableLiberalAsm(bool enable) { assembler.setLiberalAsm(enable); }
+
+void lc3::as::setEnableIncrementalAsm(bool enable)
+{
+    enable_incremental_asm = enable;
+    if(! enable) {
+        sessions.clear();
+    }
+}
+
+void lc3::as::setCacheDirectory(std::string const & directory, uint64_t max_size)
+{
+    if(directory == "") {
+        cache = nullptr;
+    } else {
+        cache = std::make_shared<core::AssemblyCache>(directory, max_size);
+    }
+}
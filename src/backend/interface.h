@@ -12,16 +12,47 @@
     #endif
 #endif
 
+#ifndef DEFAULT_ASM_CACHE_SIZE
+    #define DEFAULT_ASM_CACHE_SIZE (64 * 1024 * 1024)
+#endif
+
+#ifndef PROGRESS_QUEUE_SIZE
+    #define PROGRESS_QUEUE_SIZE 64
+#endif
+
+#include <chrono>
 #include <functional>
+#include <map>
+#include <memory>
 #include <utility>
 
+#include "asm_cache.h"
+#include <atomic>
+#include <mutex>
+
 #include "assembler.h"
 #include "converter.h"
 #include "simulator.h"
+#include "spsc_queue.h"
 #include "utils.h"
 
 namespace lc3
 {
+    // Snapshot of a run in progress, published by the thread that is running the simulator.
+    struct SimProgress
+    {
+        SimProgress(void) : inst_exec_count(0), pc(0), finished(false) {}
+
+        uint64_t inst_exec_count;
+        uint16_t pc;
+        // Output printed since the previous update, if output is being collected.
+        std::string output;
+        // Memory modified since the previous update, if modified ranges are being collected.
+        std::vector<std::pair<uint16_t, uint16_t>> modified_ranges;
+        // Set for the update published when a run ends.
+        bool finished;
+    };
+
     class sim
     {
     public:
@@ -30,6 +61,7 @@ namespace lc3
         sim(utils::IPrinter & printer, utils::IInputter & inputter, uint32_t print_level);
 
         bool loadObjFile(std::string const & filename);
+        void loadObj(core::ObjectMemorySink const & obj);
         void setup(void);
         void zeroState(void);
         uint64_t randomizeState(uint64_t seed = 0);
@@ -42,9 +74,15 @@ namespace lc3
         bool stepIn(void);
         bool stepOver(void);
         bool stepOut(void);
+        // Keep the devices (e.g. the inputter) started between runs until endSession is called, which makes stepping
+        // much cheaper. The inputter is not told that input ended between runs during a session.
+        void beginSession(void) { simulator.beginSession(); }
+        void endSession(void) { simulator.endSession(); }
 
         uint16_t readReg(uint16_t id) const;
         uint16_t readMem(uint16_t addr) const;
+        // Read count consecutive memory locations, wrapping around at xFFFF, into values.
+        void readMemRange(uint16_t start, uint32_t count, uint16_t * values) const;
         std::string getMemLine(uint16_t addr) const;
         uint16_t readPC(void) const;
         uint16_t readPSR(void) const;
@@ -58,12 +96,96 @@ namespace lc3
         void writePSR(uint16_t value);
         void writeMCR(uint16_t value);
         void writeCC(char value);
+        // Memory that changed since the previous call, as inclusive address ranges. The ranges may also include some
+        // unchanged memory.
+        std::vector<std::pair<uint16_t, uint16_t>> getAndClearModifiedRanges(void);
+
+        // Publish a SimProgress every inst_interval instructions and/or every time_interval_ms milliseconds while
+        // running, and once more whenever a run ends. When include_output is set, printed output is diverted into
+        // the updates instead of the printer. Zero for both intervals disables updates. Must not be called while
+        // running.
+        void setProgressUpdates(uint64_t inst_interval, uint32_t time_interval_ms, bool include_output,
+            bool include_modified_ranges);
+        // Take the oldest pending update without stopping the simulator. May be called from one thread other than
+        // the one running the simulator. Updates are skipped while the queue is full; whatever they would have
+        // carried is included in the next update that is published. The update that ends a run is never skipped, but
+        // held back until the queue has been drained.
+        bool getProgressUpdate(SimProgress & progress);
+
+        // Count the instructions executed at each address, of each opcode, and by each subroutine. Enabling the
+        // profiler when it is already enabled keeps the existing counts.
+        void setEnableProfiler(bool enable);
+        void resetProfiler(void);
+        uint64_t getAddrExecCount(uint16_t addr) const;
+        uint64_t getOpcodeExecCount(uint16_t opcode) const;
+        std::vector<core::SubroutineProfile> getSubroutineProfiles(void) const;
+        std::string getProfileJSON(void) const;
+        std::string getProfileFoldedStacks(void) const;
+
+        // Record every executed instruction, and the registers and memory it modified, to a binary trace file.
+        bool startTrace(std::string const & filename);
+        void stopTrace(void);
+
+        // Remember executed instructions, using at most max_size bytes, so that they can be undone. A copy of the
+        // whole machine is kept every checkpoint_interval instructions; stepping back further than the most recent
+        // instructions re-executes from the closest copy without printing anything. Modifying the machine between
+        // runs discards the history. Input consumed and output printed by the program are never undone. Copies taken
+        // before a device changed (input was delivered, the timer expired, or the program wrote a device register
+        // other than DDR) are discarded, and only the most recent instructions can be undone while the timer runs.
+        void setEnableReverse(bool enable, uint64_t max_size = DEFAULT_HISTORY_SIZE,
+            uint64_t checkpoint_interval = DEFAULT_HISTORY_CHECKPOINT_INTERVAL);
+        // Undo the last count instructions. Returns false if fewer instructions are remembered, in which case the
+        // machine is returned to the oldest remembered state.
+        bool stepBack(uint64_t count = 1);
+        // Undo instructions until the PC is at a breakpoint. Returns false if no breakpoint was reached before the
+        // oldest remembered state.
+        bool reverseContinue(void);
+
+        // Perform the OS's GETC, OUT, PUTS, IN, PUTSP, and HALT traps directly instead of executing the OS routines,
+        // as long as the trap vector table and the routines have not been replaced. Each trap performed directly
+        // counts as inst_charge instructions. The supervisor stack is not written to, and the machine stays in user
+        // mode with the program's R6 and condition codes. HALT sets R0 and R1 as the OS routine does, but leaves the
+        // PC at the HALT instruction rather than inside the routine.
+        void setEnableNativeTraps(bool enable, uint64_t inst_charge = 1);
+
+        // Fast-forward loops that do nothing but poll KBSR, DSR, or TMCR (e.g. "LDI R0, KBSR_PTR ; BRzp back") until
+        // a device could change state, which needs an inputter that knows when its next character arrives. The
+        // machine and instruction count are left exactly as executing the loop would have, but all of the skipped
+        // instructions are reported by a single PRE_INST and POST_INST callback. Loops are not skipped while
+        // profiling, tracing, reversing, or stepping over an instruction.
+        void setEnablePollSkipping(bool enable);
+
+        // Track writes to the video memory at xC000-xFDFF, which holds 128x124 pixels formatted as xRRRRRGGGGGBBBBB.
+        // The pixels can be read with readMemRange.
+        void setEnableFramebuffer(bool enable);
+        // Pixels written since the previous call, or since the framebuffer was enabled.
+        std::vector<core::FramebufferRect> getAndClearFramebufferDirtyRects(void);
+        bool writeFramebufferPPM(std::string const & filename) const;
+
+        // Add a memory-mapped device. Returns false if any of its registers are outside of xFE00-xFFFF or are
+        // already mapped. Devices that only need to be updated occasionally should return false from needsTick and
+        // schedule their updates through getDeviceScheduler.
+        bool registerDevice(core::PIDevice device);
+        core::IDeviceScheduler & getDeviceScheduler(void);
 
         void setBreakpoint(uint16_t addr);
         void removeBreakpoint(uint16_t addr);
 
+        // A run that was stopped because it stopped making progress would have reached any instruction limit that was
+        // set, so it counts as having exceeded the limit.
         bool didExceedInstLimit(void) const;
 
+        // Stop a run early once the machine returns to a state it was already in while no device or input can change
+        // it (e.g. an infinite loop after all of the input was consumed), checking every interval instructions.
+        void setEnableLoopDetection(bool enable, uint64_t interval = DEFAULT_LOOP_CHECK_INTERVAL);
+        // Whether the most recent run was stopped because the machine stopped making progress.
+        bool didDetectNoProgress(void) const { return simulator.didDetectLoop(); }
+
+        // Keep at most limit characters of output in the printer (0 means no limit), and optionally stop running once
+        // the program prints more. Only printers that keep their output are limited.
+        void setOutputLimit(uint64_t limit, bool stop_on_exceed);
+        bool didExceedOutputLimit(void) const { return progress_printer.didExceedOutputLimit(); }
+
         void registerCallback(core::CallbackType type, Callback func);
 
         utils::IPrinter & getPrinter(void);
@@ -131,8 +253,39 @@ namespace lc3
 #endif
 
     private:
+        // Forwards everything to the user's printer, unless output is being collected for progress updates.
+        class ProgressPrinter : public utils::IPrinter
+        {
+        public:
+            ProgressPrinter(utils::IPrinter & printer) : printer(printer), capture(false) {}
+
+            virtual void setColor(utils::PrintColor color) override { if(! capture) { printer.setColor(color); } }
+            virtual void print(std::string const & string) override;
+            virtual void newline(void) override;
+            virtual void flush(void) override { printer.flush(); }
+            // Collected output is kept until it is published, so it counts against the limit as well.
+            virtual void setOutputLimit(uint64_t limit) override
+            {
+                limiter.setLimit(limit);
+                printer.setOutputLimit(limit);
+            }
+            virtual bool didExceedOutputLimit(void) const override
+            {
+                return limiter.didExceed() || printer.didExceedOutputLimit();
+            }
+
+            utils::IPrinter & printer;
+            bool capture;
+            std::string buffer;
+            utils::OutputLimiter limiter;
+
+        private:
+            void collect(std::string const & string);
+        };
+
         utils::IPrinter & printer;
         utils::IInputter & inputter;
+        ProgressPrinter progress_printer;
         core::Simulator simulator;
 
         enum class RunType
@@ -150,8 +303,22 @@ namespace lc3
 
         std::unordered_map<core::CallbackType, Callback> callbacks;
 
+        bool progress_enabled;
+        uint64_t progress_inst_interval, next_progress_inst;
+        std::chrono::milliseconds progress_time_interval;
+        std::chrono::steady_clock::time_point next_progress_time;
+        bool progress_modified_ranges;
+        utils::SPSCQueue<SimProgress> progress_queue;
+        // Update that ended a run while the queue was full. Later updates are merged into it until it is taken, so
+        // that they stay in order.
+        std::atomic<bool> progress_held;
+        std::mutex progress_held_mutex;
+        SimProgress progress_held_update;
+
         void loadOS(void);
         bool runHelper(void);
+        void publishProgress(bool finished);
+        void collectProgress(SimProgress & progress, bool finished);
         static void callbackDispatcher(sim * sim_inst, core::CallbackType type, core::MachineState & state);
     };
 
@@ -162,12 +329,33 @@ namespace lc3
         ~as(void) = default;
 
         optional<std::pair<std::string, core::SymbolTable>> assemble(std::string const & asm_filename);
+        optional<core::SymbolTable> assemble(std::string const & asm_filename, core::IObjectSink & sink);
+        // Warnings and errors reported by the most recent assembly.
+        std::vector<utils::AssemblerDiagnostic> const & getDiagnostics(void) const
+        {
+            return assembler.getDiagnostics();
+        }
 
         void setEnableLiberalAsm(bool enable);
+        // Keep the results of each assembly so that re-assembling an edited file only re-processes what changed.
+        void setEnableIncrementalAsm(bool enable);
+        // Reuse objects from earlier assemblies of identical sources, possibly by other processes, by caching them
+        // in directory. The least recently used objects are evicted once the cache exceeds max_size bytes. An empty
+        // directory disables the cache.
+        void setCacheDirectory(std::string const & directory, uint64_t max_size = DEFAULT_ASM_CACHE_SIZE);
 
     private:
         utils::IPrinter & printer;
         core::Assembler assembler;
+        bool enable_incremental_asm;
+        std::map<std::string, core::AssemblerSession> sessions;
+        std::shared_ptr<core::AssemblyCache> cache;
+
+        core::SymbolTable assembleStream(std::string const & asm_filename, std::istream & in_file,
+            core::IObjectSink & sink);
+
+        optional<core::SymbolTable> assembleHelper(std::string const & asm_filename, std::istream & in_file,
+            core::IObjectSink & sink);
     };
 
     class conv
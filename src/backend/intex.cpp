@@ -17,6 +17,7 @@ uint8_t lc3::core::getInterruptVector(InterruptType type)
 {
     switch(type) {
         case InterruptType::KEYBOARD: return 0x80;
+        case InterruptType::TIMER: return 0x81;
         default: return 0x00;
     }
 }
@@ -25,6 +26,7 @@ uint8_t lc3::core::getInterruptPriority(InterruptType type)
 {
     switch(type) {
         case InterruptType::KEYBOARD: return 0x04;
+        case InterruptType::TIMER: return 0x05;
         default: return 0x00;
     }
 }
@@ -33,6 +35,7 @@ std::string lc3::core::interruptTypeToString(InterruptType type)
 {
     switch(type) {
         case InterruptType::KEYBOARD: return "keyboard";
+        case InterruptType::TIMER: return "timer";
         default: return "invalid";
     }
 }
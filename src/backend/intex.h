@@ -22,6 +22,7 @@ namespace core
     enum class InterruptType
     {
           KEYBOARD
+        , TIMER
         , INVALID
     };
 
@@ -30,6 +31,21 @@ namespace core
     uint8_t getInterruptVector(InterruptType type);
     uint8_t getInterruptPriority(InterruptType type);
     std::string interruptTypeToString(InterruptType type);
+
+    // An interrupt that was raised by a device but has not been handled yet. Devices whose vector is programmable
+    // provide their own vector instead of the default one for the type.
+    struct Interrupt
+    {
+        Interrupt(void) : Interrupt(InterruptType::INVALID) { }
+        Interrupt(InterruptType type) : Interrupt(type, getInterruptVector(type), getInterruptPriority(type)) { }
+        Interrupt(InterruptType type, uint8_t vector, uint8_t priority) :
+            type(type), vector(vector), priority(priority)
+        { }
+
+        InterruptType type;
+        uint8_t vector;
+        uint8_t priority;
+    };
 };
 };
 
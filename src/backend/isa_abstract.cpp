@@ -32,6 +32,20 @@ IInstruction::IInstruction(std::string const & name, std::vector<PIOperand> cons
     this->operands = operands;
 }
 
+IInstruction::IInstruction(InstDesc const & desc) : name(desc.name)
+{
+    for(uint32_t i = 0; i < desc.operand_count; i += 1) {
+        OperandDesc const & op = desc.operands[i];
+        switch(op.kind) {
+            case OperandKind::FIXED: operands.push_back(std::make_shared<FixedOperand>(op.width, op.value)); break;
+            case OperandKind::REG: operands.push_back(std::make_shared<RegOperand>(op.width)); break;
+            case OperandKind::NUM: operands.push_back(std::make_shared<NumOperand>(op.width, false)); break;
+            case OperandKind::SEXT_NUM: operands.push_back(std::make_shared<NumOperand>(op.width, true)); break;
+            case OperandKind::LABEL: operands.push_back(std::make_shared<LabelOperand>(op.width)); break;
+        }
+    }
+}
+
 IInstruction::IInstruction(IInstruction const & that)
 {
     this->name = that.name;
@@ -149,7 +163,6 @@ lc3::optional<uint32_t> LabelOperand::encode(asmbl::Statement const & statement,
         auto search = symbols.find(toLower(piece.str));
         if(search == symbols.end()) {
             logger.asmPrintf(PrintType::P_ERROR, statement, piece, "could not find label");
-            logger.newline();
             return {};
         }
 
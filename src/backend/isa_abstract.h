@@ -8,6 +8,7 @@
 
 #include "aliases.h"
 #include "asm_types.h"
+#include "isa_table.h"
 #include "state.h"
 #include "utils.h"
 
@@ -24,8 +25,11 @@ namespace core
         SymbolTable const & getRegs(void) { return regs; }
 
     protected:
-        std::vector<PIInstruction> instructions;
-        SymbolTable regs;
+        // Shared by all handlers.
+        SymbolTable const & regs;
+
+        // Creates one instruction for each entry of ISA_TABLE, at the same index.
+        static std::vector<PIInstruction> createInstructions(void);
     };
 
     class IOperand
@@ -67,6 +71,7 @@ namespace core
     {
     public:
         IInstruction(std::string const & name, std::vector<PIOperand> const & operands);
+        IInstruction(InstDesc const & desc);
         IInstruction(IInstruction const & that);
         virtual ~IInstruction(void) = default;
 
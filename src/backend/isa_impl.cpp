@@ -5,52 +5,44 @@
 
 using namespace lc3::core;
 
-ISAHandler::ISAHandler(void)
+static SymbolTable const & getRegTable(void)
 {
-    regs["r0"] = 0;
-    regs["r1"] = 1;
-    regs["r2"] = 2;
-    regs["r3"] = 3;
-    regs["r4"] = 4;
-    regs["r5"] = 5;
-    regs["r6"] = 6;
-    regs["r7"] = 7;
-
-    instructions.push_back(std::make_shared<ADDRegInstruction>());
-    instructions.push_back(std::make_shared<ADDImmInstruction>());
-    instructions.push_back(std::make_shared<ANDRegInstruction>());
-    instructions.push_back(std::make_shared<ANDImmInstruction>());
-    instructions.push_back(std::make_shared<BRInstruction>());
-    instructions.push_back(std::make_shared<BRnInstruction>());
-    instructions.push_back(std::make_shared<BRzInstruction>());
-    instructions.push_back(std::make_shared<BRpInstruction>());
-    instructions.push_back(std::make_shared<BRnzInstruction>());
-    instructions.push_back(std::make_shared<BRzpInstruction>());
-    instructions.push_back(std::make_shared<BRnpInstruction>());
-    instructions.push_back(std::make_shared<BRnzpInstruction>());
-    instructions.push_back(std::make_shared<NOP0Instruction>());
-    instructions.push_back(std::make_shared<NOP1Instruction>());
-    instructions.push_back(std::make_shared<JMPInstruction>());
-    instructions.push_back(std::make_shared<JSRInstruction>());
-    instructions.push_back(std::make_shared<JSRRInstruction>());
-    instructions.push_back(std::make_shared<LDInstruction>());
-    instructions.push_back(std::make_shared<LDIInstruction>());
-    instructions.push_back(std::make_shared<LDRInstruction>());
-    instructions.push_back(std::make_shared<LEAInstruction>());
-    instructions.push_back(std::make_shared<NOTInstruction>());
-    instructions.push_back(std::make_shared<RETInstruction>());
-    instructions.push_back(std::make_shared<RTIInstruction>());
-    instructions.push_back(std::make_shared<STInstruction>());
-    instructions.push_back(std::make_shared<STIInstruction>());
-    instructions.push_back(std::make_shared<STRInstruction>());
-    instructions.push_back(std::make_shared<TRAPInstruction>());
-    instructions.push_back(std::make_shared<GETCInstruction>());
-    instructions.push_back(std::make_shared<OUTInstruction>());
-    instructions.push_back(std::make_shared<PUTCInstruction>());
-    instructions.push_back(std::make_shared<PUTSInstruction>());
-    instructions.push_back(std::make_shared<INInstruction>());
-    instructions.push_back(std::make_shared<PUTSPInstruction>());
-    instructions.push_back(std::make_shared<HALTInstruction>());
+    static SymbolTable const regs = {
+        {"r0", 0}, {"r1", 1}, {"r2", 2}, {"r3", 3}, {"r4", 4}, {"r5", 5}, {"r6", 6}, {"r7", 7}
+    };
+    return regs;
+}
+
+ISAHandler::ISAHandler(void) : regs(getRegTable()) { }
+
+std::vector<PIInstruction> ISAHandler::createInstructions(void)
+{
+    std::vector<PIInstruction> instructions;
+    for(InstDesc const & desc : ISA_TABLE) {
+        PIInstruction inst;
+        switch(desc.semantics) {
+            case InstSemantics::ADD_REG: inst = std::make_shared<ADDRegInstruction>(desc); break;
+            case InstSemantics::ADD_IMM: inst = std::make_shared<ADDImmInstruction>(desc); break;
+            case InstSemantics::AND_REG: inst = std::make_shared<ANDRegInstruction>(desc); break;
+            case InstSemantics::AND_IMM: inst = std::make_shared<ANDImmInstruction>(desc); break;
+            case InstSemantics::BR: inst = std::make_shared<BRInstruction>(desc); break;
+            case InstSemantics::JMP: inst = std::make_shared<JMPInstruction>(desc); break;
+            case InstSemantics::JSR: inst = std::make_shared<JSRInstruction>(desc); break;
+            case InstSemantics::JSRR: inst = std::make_shared<JSRRInstruction>(desc); break;
+            case InstSemantics::LD: inst = std::make_shared<LDInstruction>(desc); break;
+            case InstSemantics::LDI: inst = std::make_shared<LDIInstruction>(desc); break;
+            case InstSemantics::LDR: inst = std::make_shared<LDRInstruction>(desc); break;
+            case InstSemantics::LEA: inst = std::make_shared<LEAInstruction>(desc); break;
+            case InstSemantics::NOT: inst = std::make_shared<NOTInstruction>(desc); break;
+            case InstSemantics::RTI: inst = std::make_shared<RTIInstruction>(desc); break;
+            case InstSemantics::ST: inst = std::make_shared<STInstruction>(desc); break;
+            case InstSemantics::STI: inst = std::make_shared<STIInstruction>(desc); break;
+            case InstSemantics::STR: inst = std::make_shared<STRInstruction>(desc); break;
+            case InstSemantics::TRAP: inst = std::make_shared<TRAPInstruction>(desc); break;
+        }
+        instructions.push_back(inst);
+    }
+    return instructions;
 }
 
 PIMicroOp ADDRegInstruction::buildMicroOps(MachineState const & state) const
@@ -0,0 +1,33 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#include "isa_table.h"
+
+static std::array<uint8_t, 1 << 16> buildDecodeTable(void)
+{
+    std::array<uint8_t, 1 << 16> table;
+    table.fill(lc3::core::ISA_INVALID_INDEX);
+
+    // Fill in reverse so that earlier entries take precedence over later ones that match the same word.
+    for(uint32_t i = lc3::core::ISA_TABLE_SIZE; i > 0; i -= 1) {
+        uint16_t mask = lc3::core::getFixedMask(lc3::core::ISA_TABLE[i - 1]);
+        uint16_t bits = lc3::core::getFixedBits(lc3::core::ISA_TABLE[i - 1]);
+        // Visit every combination of the bits that are not fixed, counting down to 0.
+        uint16_t free_bits = static_cast<uint16_t>(~mask);
+        uint16_t combination = free_bits;
+        while(true) {
+            table[bits | combination] = static_cast<uint8_t>(i - 1);
+            if(combination == 0) {
+                break;
+            }
+            combination = static_cast<uint16_t>((combination - 1) & free_bits);
+        }
+    }
+    return table;
+}
+
+std::array<uint8_t, 1 << 16> const & lc3::core::getDecodeTable(void)
+{
+    static std::array<uint8_t, 1 << 16> const table = buildDecodeTable();
+    return table;
+}
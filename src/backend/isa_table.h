@@ -0,0 +1,165 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#ifndef ISA_TABLE_H
+#define ISA_TABLE_H
+
+#include <array>
+#include <cstdint>
+
+#define ISA_MAX_OPERANDS 5
+
+namespace lc3
+{
+namespace core
+{
+    enum class OperandKind : uint8_t {
+          FIXED = 0
+        , REG
+        , NUM
+        , SEXT_NUM
+        , LABEL
+    };
+
+    // Which instruction class builds the micro-ops. Aliases (e.g. BRn, RET, HALT) share the semantics of the
+    // instruction they are an encoding of.
+    enum class InstSemantics : uint8_t {
+          ADD_REG = 0
+        , ADD_IMM
+        , AND_REG
+        , AND_IMM
+        , BR
+        , JMP
+        , JSR
+        , JSRR
+        , LD
+        , LDI
+        , LDR
+        , LEA
+        , NOT
+        , RTI
+        , ST
+        , STI
+        , STR
+        , TRAP
+    };
+
+    struct OperandDesc
+    {
+        OperandKind kind;
+        uint32_t width;
+        // Only used by FIXED operands.
+        uint32_t value;
+    };
+
+    // Operands are listed from the most significant bits of the encoding down, starting with the opcode.
+    struct InstDesc
+    {
+        char const * name;
+        InstSemantics semantics;
+        uint32_t operand_count;
+        OperandDesc operands[ISA_MAX_OPERANDS];
+    };
+
+    constexpr OperandDesc fixedOp(uint32_t width, uint32_t value)
+    {
+        return OperandDesc{OperandKind::FIXED, width, value};
+    }
+    constexpr OperandDesc regOp(uint32_t width) { return OperandDesc{OperandKind::REG, width, 0}; }
+    constexpr OperandDesc numOp(uint32_t width, bool sext)
+    {
+        return OperandDesc{sext ? OperandKind::SEXT_NUM : OperandKind::NUM, width, 0};
+    }
+    constexpr OperandDesc labelOp(uint32_t width) { return OperandDesc{OperandKind::LABEL, width, 0}; }
+
+    // The single description of the ISA that both the encoder and the decoder are built from. A word decodes to the
+    // first entry whose fixed bits it matches, and the encoder tries entries with the same name in this order.
+    constexpr InstDesc ISA_TABLE[] = {
+          {"add",   InstSemantics::ADD_REG, 5, {fixedOp(4, 0x1), regOp(3), regOp(3), fixedOp(3, 0x0), regOp(3)}}
+        , {"add",   InstSemantics::ADD_IMM, 5, {fixedOp(4, 0x1), regOp(3), regOp(3), fixedOp(1, 0x1), numOp(5, true)}}
+        , {"and",   InstSemantics::AND_REG, 5, {fixedOp(4, 0x5), regOp(3), regOp(3), fixedOp(3, 0x0), regOp(3)}}
+        , {"and",   InstSemantics::AND_IMM, 5, {fixedOp(4, 0x5), regOp(3), regOp(3), fixedOp(1, 0x1), numOp(5, true)}}
+        , {"br",    InstSemantics::BR,      3, {fixedOp(4, 0x0), fixedOp(3, 0x7), labelOp(9)}}
+        , {"brn",   InstSemantics::BR,      3, {fixedOp(4, 0x0), fixedOp(3, 0x4), labelOp(9)}}
+        , {"brz",   InstSemantics::BR,      3, {fixedOp(4, 0x0), fixedOp(3, 0x2), labelOp(9)}}
+        , {"brp",   InstSemantics::BR,      3, {fixedOp(4, 0x0), fixedOp(3, 0x1), labelOp(9)}}
+        , {"brnz",  InstSemantics::BR,      3, {fixedOp(4, 0x0), fixedOp(3, 0x6), labelOp(9)}}
+        , {"brzp",  InstSemantics::BR,      3, {fixedOp(4, 0x0), fixedOp(3, 0x3), labelOp(9)}}
+        , {"brnp",  InstSemantics::BR,      3, {fixedOp(4, 0x0), fixedOp(3, 0x5), labelOp(9)}}
+        , {"brnzp", InstSemantics::BR,      3, {fixedOp(4, 0x0), fixedOp(3, 0x7), labelOp(9)}}
+        , {"nop",   InstSemantics::BR,      3, {fixedOp(4, 0x0), fixedOp(3, 0x0), fixedOp(9, 0x0)}}
+        , {"nop",   InstSemantics::BR,      3, {fixedOp(4, 0x0), fixedOp(3, 0x0), labelOp(9)}}
+        , {"jmp",   InstSemantics::JMP,     4, {fixedOp(4, 0xc), fixedOp(3, 0x0), regOp(3), fixedOp(6, 0x0)}}
+        , {"jsr",   InstSemantics::JSR,     3, {fixedOp(4, 0x4), fixedOp(1, 0x1), labelOp(11)}}
+        , {"jsrr",  InstSemantics::JSRR,    5, {fixedOp(4, 0x4), fixedOp(1, 0x0), fixedOp(2, 0x0), regOp(3),
+                                                fixedOp(6, 0x0)}}
+        , {"ld",    InstSemantics::LD,      3, {fixedOp(4, 0x2), regOp(3), labelOp(9)}}
+        , {"ldi",   InstSemantics::LDI,     3, {fixedOp(4, 0xa), regOp(3), labelOp(9)}}
+        , {"ldr",   InstSemantics::LDR,     4, {fixedOp(4, 0x6), regOp(3), regOp(3), numOp(6, true)}}
+        , {"lea",   InstSemantics::LEA,     3, {fixedOp(4, 0xe), regOp(3), labelOp(9)}}
+        , {"not",   InstSemantics::NOT,     4, {fixedOp(4, 0x9), regOp(3), regOp(3), fixedOp(6, 0x3f)}}
+        , {"ret",   InstSemantics::JMP,     4, {fixedOp(4, 0xc), fixedOp(3, 0x0), fixedOp(3, 0x7), fixedOp(6, 0x0)}}
+        , {"rti",   InstSemantics::RTI,     2, {fixedOp(4, 0x8), fixedOp(12, 0x0)}}
+        , {"st",    InstSemantics::ST,      3, {fixedOp(4, 0x3), regOp(3), labelOp(9)}}
+        , {"sti",   InstSemantics::STI,     3, {fixedOp(4, 0xb), regOp(3), labelOp(9)}}
+        , {"str",   InstSemantics::STR,     4, {fixedOp(4, 0x7), regOp(3), regOp(3), numOp(6, true)}}
+        , {"trap",  InstSemantics::TRAP,    3, {fixedOp(4, 0xf), fixedOp(4, 0x0), numOp(8, false)}}
+        , {"getc",  InstSemantics::TRAP,    3, {fixedOp(4, 0xf), fixedOp(4, 0x0), fixedOp(8, 0x20)}}
+        , {"out",   InstSemantics::TRAP,    3, {fixedOp(4, 0xf), fixedOp(4, 0x0), fixedOp(8, 0x21)}}
+        , {"putc",  InstSemantics::TRAP,    3, {fixedOp(4, 0xf), fixedOp(4, 0x0), fixedOp(8, 0x21)}}
+        , {"puts",  InstSemantics::TRAP,    3, {fixedOp(4, 0xf), fixedOp(4, 0x0), fixedOp(8, 0x22)}}
+        , {"in",    InstSemantics::TRAP,    3, {fixedOp(4, 0xf), fixedOp(4, 0x0), fixedOp(8, 0x23)}}
+        , {"putsp", InstSemantics::TRAP,    3, {fixedOp(4, 0xf), fixedOp(4, 0x0), fixedOp(8, 0x24)}}
+        , {"halt",  InstSemantics::TRAP,    3, {fixedOp(4, 0xf), fixedOp(4, 0x0), fixedOp(8, 0x25)}}
+    };
+
+    constexpr uint32_t ISA_TABLE_SIZE = sizeof(ISA_TABLE) / sizeof(ISA_TABLE[0]);
+    // Decode table entry of a word that does not match any instruction.
+    constexpr uint8_t ISA_INVALID_INDEX = 0xff;
+
+    // Fixed bits of the encoding from the operands at idx and after, where pos is one past the most significant bit
+    // of operand idx.
+    constexpr uint16_t getFixedMask(InstDesc const & desc, uint32_t idx = 0, uint32_t pos = 16)
+    {
+        return idx >= desc.operand_count ? 0 : static_cast<uint16_t>(
+            (desc.operands[idx].kind == OperandKind::FIXED ?
+                ((1u << desc.operands[idx].width) - 1) << (pos - desc.operands[idx].width) : 0) |
+            getFixedMask(desc, idx + 1, pos - desc.operands[idx].width));
+    }
+
+    constexpr uint16_t getFixedBits(InstDesc const & desc, uint32_t idx = 0, uint32_t pos = 16)
+    {
+        return idx >= desc.operand_count ? 0 : static_cast<uint16_t>(
+            (desc.operands[idx].kind == OperandKind::FIXED ?
+                desc.operands[idx].value << (pos - desc.operands[idx].width) : 0) |
+            getFixedBits(desc, idx + 1, pos - desc.operands[idx].width));
+    }
+
+    constexpr uint32_t getEncodingWidth(InstDesc const & desc, uint32_t idx = 0)
+    {
+        return idx >= desc.operand_count ? 0 : desc.operands[idx].width + getEncodingWidth(desc, idx + 1);
+    }
+
+    constexpr bool hasValidOperands(InstDesc const & desc, uint32_t idx = 0)
+    {
+        return idx >= desc.operand_count || (desc.operands[idx].width > 0 &&
+            desc.operands[idx].value < (1u << desc.operands[idx].width) && hasValidOperands(desc, idx + 1));
+    }
+
+    constexpr bool isValidISATable(uint32_t idx = 0)
+    {
+        return idx >= ISA_TABLE_SIZE || (ISA_TABLE[idx].operand_count <= ISA_MAX_OPERANDS &&
+            ISA_TABLE[idx].operands[0].kind == OperandKind::FIXED && hasValidOperands(ISA_TABLE[idx]) &&
+            getEncodingWidth(ISA_TABLE[idx]) == 16 && isValidISATable(idx + 1));
+    }
+
+    static_assert(ISA_TABLE_SIZE < ISA_INVALID_INDEX, "ISA table does not fit in the decode table");
+    static_assert(isValidISATable(), "every ISA table entry must encode to 16 bits, starting with the opcode");
+
+    // Index into ISA_TABLE of the instruction that each word decodes to, or ISA_INVALID_INDEX. Generated from
+    // ISA_TABLE the first time it is used and shared afterwards.
+    std::array<uint8_t, 1 << 16> const & getDecodeTable(void);
+};
+};
+
+#endif
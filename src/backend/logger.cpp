@@ -0,0 +1,157 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#include <string>
+
+#include "logger.h"
+
+void lc3::utils::Logger::printMessage(lc3::utils::PrintType type, bool bold, std::string const & message) const
+{
+    lc3::utils::PrintColor color = lc3::utils::PrintColor::RESET;
+    std::string label = "";
+
+    switch(type) {
+        case PrintType::P_ERROR:
+            color = lc3::utils::PrintColor::RED;
+            label = "error";
+            break;
+
+        case PrintType::P_WARNING:
+            color = lc3::utils::PrintColor::YELLOW;
+            label = "warning";
+            break;
+
+        case PrintType::P_NOTE:
+            color = lc3::utils::PrintColor::GRAY;
+            label = "note";
+            break;
+
+        case PrintType::P_INFO:
+            color = lc3::utils::PrintColor::GREEN;
+            label = "info";
+            break;
+
+        case PrintType::P_DEBUG:
+            color = lc3::utils::PrintColor::MAGENTA;
+            label = "debug";
+            break;
+
+        case PrintType::P_EXTRA:
+            color = lc3::utils::PrintColor::BLUE;
+            label = "extra";
+            break;
+
+        case PrintType::P_SPAM:
+            label = "spam";
+
+        default: break;
+    }
+
+    printer.setColor(lc3::utils::PrintColor::BOLD);
+    printer.setColor(color);
+    printer.print(lc3::utils::ssprintf("%s: ", label.c_str()));
+    printer.setColor(lc3::utils::PrintColor::RESET);
+
+    if(bold) {
+        printer.setColor(lc3::utils::PrintColor::BOLD);
+    }
+
+    printer.print(message);
+    printer.setColor(lc3::utils::PrintColor::RESET);
+
+    printer.newline();
+}
+
+void lc3::utils::AssemblerLogger::clearDiagnostics(void)
+{
+    diagnostics.clear();
+    printed_diagnostics = 0;
+}
+
+void lc3::utils::AssemblerLogger::printDiagnostics(void) const
+{
+    while(printed_diagnostics < diagnostics.size()) {
+        printDiagnostic(diagnostics[printed_diagnostics]);
+        ++printed_diagnostics;
+    }
+}
+
+void lc3::utils::AssemblerLogger::printDiagnostic(lc3::utils::AssemblerDiagnostic const & diagnostic) const
+{
+    if(isLevelEnabled(diagnostic.level)) {
+        printer.setColor(lc3::utils::PrintColor::BOLD);
+        printer.print(lc3::utils::ssprintf("%s:%d:%d: ", diagnostic.filename.c_str(), diagnostic.row + 1,
+            diagnostic.col + 1));
+
+        printMessage(diagnostic.level, true, diagnostic.message);
+        printer.print(diagnostic.line);
+        printer.newline();
+
+        printer.setColor(lc3::utils::PrintColor::BOLD);
+        printer.setColor(lc3::utils::PrintColor::GREEN);
+
+        for(uint32_t i = 0; i < diagnostic.col; i++) {
+            printer.print(" ");
+        }
+        printer.print("^");
+
+        if(diagnostic.len > 0) {
+            for(uint32_t i = 0; i < diagnostic.len - 1; i++) {
+                printer.print("~");
+            }
+        }
+
+        printer.setColor(lc3::utils::PrintColor::RESET);
+        printer.newline();
+
+        if(isLevelEnabled(PrintType::P_NOTE)) {
+            for(std::string const & note : diagnostic.notes) {
+                printMessage(PrintType::P_NOTE, false, note);
+            }
+        }
+    }
+
+    newline(diagnostic.level);
+}
+
+static std::string toJSONString(std::string const & str)
+{
+    std::string ret = "\"";
+    for(char c : str) {
+        switch(c) {
+            case '"': ret += "\\\""; break;
+            case '\\': ret += "\\\\"; break;
+            case '\n': ret += "\\n"; break;
+            case '\r': ret += "\\r"; break;
+            case '\t': ret += "\\t"; break;
+            default:
+                if(static_cast<unsigned char>(c) < 0x20) {
+                    ret += lc3::utils::ssprintf("\\u%04x", static_cast<unsigned char>(c));
+                } else {
+                    ret += c;
+                }
+                break;
+        }
+    }
+    ret += "\"";
+    return ret;
+}
+
+static std::string toJSONArray(std::vector<std::string> const & strs)
+{
+    std::string ret = "[";
+    for(uint32_t i = 0; i < strs.size(); i += 1) {
+        if(i > 0) { ret += ","; }
+        ret += toJSONString(strs[i]);
+    }
+    ret += "]";
+    return ret;
+}
+
+std::string lc3::utils::AssemblerDiagnostic::toJSON(void) const
+{
+    return lc3::utils::ssprintf("{\"file\":%s,\"row\":%d,\"col\":%d,\"len\":%d,\"severity\":%s,\"id\":%s,"
+        "\"args\":%s,\"message\":%s,\"notes\":%s}", toJSONString(filename).c_str(), row + 1, col + 1, len,
+        level == PrintType::P_WARNING ? "\"warning\"" : "\"error\"", toJSONString(id).c_str(),
+        toJSONArray(args).c_str(), toJSONString(message).c_str(), toJSONArray(notes).c_str());
+}
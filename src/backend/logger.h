@@ -19,14 +19,22 @@ namespace utils
     protected:
         lc3::utils::IPrinter & printer;
         uint32_t print_level;
+        mutable uint32_t diagnostic_count;
+
+        void countDiagnostic(PrintType type) const {
+            if(type >= PrintType::P_FATAL_ERROR && type <= PrintType::P_WARNING) { ++diagnostic_count; }
+        }
 
     public:
-        Logger(IPrinter & printer, uint32_t print_level) : printer(printer), print_level(print_level) {}
+        Logger(IPrinter & printer, uint32_t print_level) : printer(printer), print_level(print_level),
+            diagnostic_count(0) {}
 
         lc3::utils::IPrinter & getPrinter(void) const { return printer; }
 
         template<typename ... Args>
         void printf(PrintType level, bool bold, std::string const & format, Args ... args) const;
+        void printMessage(PrintType level, bool bold, std::string const & message) const;
+        bool isLevelEnabled(PrintType level) const { return static_cast<uint32_t>(level) <= print_level; }
         void newline(PrintType level = PrintType::P_ERROR) const {
             if(print_level > static_cast<uint32_t>(level)) { printer.newline(); }
         }
@@ -35,6 +43,25 @@ namespace utils
         }
         uint32_t getPrintLevel(void) const { return print_level; }
         void setPrintLevel(uint32_t print_level) { this->print_level = print_level; }
+        // Number of warnings and errors reported so far, including those suppressed by the print level.
+        uint32_t getDiagnosticCount(void) const { return diagnostic_count; }
+    };
+
+    // A warning or error reported by the assembler. Diagnostics are recorded as they are found and printed once
+    // the current pass is complete.
+    struct AssemblerDiagnostic
+    {
+        PrintType level;
+        std::string filename;
+        uint32_t row, col, len;
+        std::string line;
+        // The format string of the message, which identifies the kind of diagnostic regardless of its arguments.
+        std::string id;
+        std::vector<std::string> args;
+        std::string message;
+        std::vector<std::string> notes;
+
+        std::string toJSON(void) const;
     };
 
     class AssemblerLogger : public Logger
@@ -44,7 +71,7 @@ namespace utils
 
         AssemblerLogger(IPrinter & printer, uint32_t print_level) : AssemblerLogger(printer, print_level, "") {}
         AssemblerLogger(IPrinter & printer, uint32_t print_level, std::string const & filename) :
-            Logger(printer, print_level), filename(filename) {}
+            Logger(printer, print_level), filename(filename), printed_diagnostics(0) {}
 
         void setFilename(std::string const & filename) { this->filename = filename; }
 
@@ -57,69 +84,40 @@ namespace utils
         template<typename ... Args>
         void asmPrintf(PrintType level, uint32_t row_num, uint32_t col_num, uint32_t len, std::string const & line,
             std::string const & format, Args ... args) const;
+        // Attach a note to the most recently reported diagnostic.
+        template<typename ... Args>
+        void asmNote(std::string const & format, Args ... args) const;
+
+        std::vector<AssemblerDiagnostic> const & getDiagnostics(void) const { return diagnostics; }
+        void clearDiagnostics(void);
+        void printDiagnostics(void) const;
 
         std::string filename;
+
+    private:
+        mutable std::vector<AssemblerDiagnostic> diagnostics;
+        mutable uint32_t printed_diagnostics;
+
+        template<typename ... Args>
+        void record(PrintType level, std::string const & source_filename, uint32_t row_num, uint32_t col_num,
+            uint32_t len, std::string const & line, std::string const & format, Args ... args) const;
+
+        void printDiagnostic(AssemblerDiagnostic const & diagnostic) const;
     };
+
+    inline std::string toDiagnosticArg(char const * arg) { return arg; }
+    inline std::string toDiagnosticArg(std::string const & arg) { return arg; }
+    template<typename T>
+    std::string toDiagnosticArg(T arg) { return std::to_string(arg); }
 };
 };
 
 template<typename ... Args>
 void lc3::utils::Logger::printf(lc3::utils::PrintType type, bool bold, std::string const & format, Args ... args) const
 {
-    lc3::utils::PrintColor color = lc3::utils::PrintColor::RESET;
-    std::string label = "";
-
-    if(static_cast<uint32_t>(type) <= print_level) {
-        switch(type) {
-            case PrintType::P_ERROR:
-                color = lc3::utils::PrintColor::RED;
-                label = "error";
-                break;
-
-            case PrintType::P_WARNING:
-                color = lc3::utils::PrintColor::YELLOW;
-                label = "warning";
-                break;
-
-            case PrintType::P_NOTE:
-                color = lc3::utils::PrintColor::GRAY;
-                label = "note";
-                break;
-
-            case PrintType::P_INFO:
-                color = lc3::utils::PrintColor::GREEN;
-                label = "info";
-                break;
-
-            case PrintType::P_DEBUG:
-                color = lc3::utils::PrintColor::MAGENTA;
-                label = "debug";
-                break;
-
-            case PrintType::P_EXTRA:
-                color = lc3::utils::PrintColor::BLUE;
-                label = "extra";
-                break;
-
-            case PrintType::P_SPAM:
-                label = "spam";
-
-            default: break;
-        }
-
-        printer.setColor(lc3::utils::PrintColor::BOLD);
-        printer.setColor(color);
-        printer.print(lc3::utils::ssprintf("%s: ", label.c_str()));
-        printer.setColor(lc3::utils::PrintColor::RESET);
-
-        if(bold) {
-            printer.setColor(lc3::utils::PrintColor::BOLD);
-        }
-
-        printer.print(lc3::utils::ssprintf(format, args...));
-        printer.setColor(lc3::utils::PrintColor::RESET);
-
-        printer.newline();
+    countDiagnostic(type);
+    if(isLevelEnabled(type)) {
+        printMessage(type, bold, lc3::utils::ssprintf(format, args...));
     }
 }
 
@@ -128,45 +126,41 @@ void lc3::utils::AssemblerLogger::asmPrintf(lc3::utils::PrintType level,
     lc3::core::asmbl::Statement const & statement, lc3::core::asmbl::StatementPiece const & piece,
     std::string const & format, Args ... args) const
 {
-    asmPrintf(level, statement.row, piece.col, piece.len, statement.line, format, args...);
+    record(level, statement.filename.empty() ? filename : statement.filename, statement.row, piece.col, piece.len,
+        statement.line, format, args...);
 }
 
 template<typename ... Args>
 void lc3::utils::AssemblerLogger::asmPrintf(lc3::utils::PrintType level,
     lc3::core::asmbl::Statement const & statement, std::string const & format, Args ... args) const
 {
-    asmPrintf(level, statement.row, 0, (uint32_t) statement.line.size(), statement.line, format, args...);
+    record(level, statement.filename.empty() ? filename : statement.filename, statement.row, 0,
+        (uint32_t) statement.line.size(), statement.line, format, args...);
 }
 
 template<typename ... Args>
 void lc3::utils::AssemblerLogger::asmPrintf(lc3::utils::PrintType level, uint32_t row_num, uint32_t col_num,
     uint32_t len, std::string const & line, std::string const & format, Args ... args) const
 {
-    if(static_cast<uint32_t>(level) > print_level) { return; }
-
-    printer.setColor(lc3::utils::PrintColor::BOLD);
-    printer.print(lc3::utils::ssprintf("%s:%d:%d: ", filename.c_str(), row_num + 1, col_num + 1));
-
-    printf(level, true, format, args...);
-    printer.print(lc3::utils::ssprintf("%s", line.c_str()));
-    printer.newline();
-
-    printer.setColor(lc3::utils::PrintColor::BOLD);
-    printer.setColor(lc3::utils::PrintColor::GREEN);
+    record(level, filename, row_num, col_num, len, line, format, args...);
+}
 
-    for(uint32_t i = 0; i < col_num; i++) {
-        printer.print(" ");
-    }
-    printer.print("^");
+template<typename ... Args>
+void lc3::utils::AssemblerLogger::record(lc3::utils::PrintType level, std::string const & source_filename,
+    uint32_t row_num, uint32_t col_num, uint32_t len, std::string const & line, std::string const & format,
+    Args ... args) const
+{
+    countDiagnostic(level);
+    diagnostics.push_back(AssemblerDiagnostic{level, source_filename, row_num, col_num, len, line, format,
+        {toDiagnosticArg(args)...}, lc3::utils::ssprintf(format, args...), {}});
+}
 
-    if(len > 0) {
-        for(uint32_t i = 0; i < len - 1; i++) {
-            printer.print("~");
-        }
+template<typename ... Args>
+void lc3::utils::AssemblerLogger::asmNote(std::string const & format, Args ... args) const
+{
+    if(diagnostics.size() > 0) {
+        diagnostics.back().notes.push_back(lc3::utils::ssprintf(format, args...));
     }
-
-    printer.setColor(lc3::utils::PrintColor::RESET);
-    printer.newline();
 }
 
 #endif
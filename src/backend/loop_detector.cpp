@@ -0,0 +1,128 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#include <algorithm>
+
+#include "device_regs.h"
+#include "loop_detector.h"
+#include "state.h"
+
+static constexpr uint32_t NUM_PAGES = MMIO_START / lc3::core::LoopDetector::PAGE_SIZE;
+static constexpr uint64_t FNV_OFFSET = 0xcbf29ce484222325ull;
+static constexpr uint64_t FNV_PRIME = 0x00000100000001b3ull;
+
+constexpr uint32_t lc3::core::LoopDetector::PAGE_SIZE;
+
+static uint64_t hashWords(uint64_t hash, uint16_t const * words, std::size_t count)
+{
+    for(std::size_t i = 0; i < count; i += 1) {
+        hash = (hash ^ words[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+lc3::core::LoopDetector::LoopDetector(uint64_t interval) : interval(std::max<uint64_t>(interval, 1)),
+    dirty_pages((NUM_PAGES + 63) / 64), page_hashes(NUM_PAGES, 0), mem_hash(0), device_written(false),
+    has_saved(false), checks_since_save(0), save_distance(1)
+{
+    markAllDirty();
+}
+
+void lc3::core::LoopDetector::markAllDirty(void)
+{
+    std::fill(dirty_pages.begin(), dirty_pages.end(), ~0ull);
+}
+
+void lc3::core::LoopDetector::reset(void)
+{
+    device_written = false;
+    has_saved = false;
+    checks_since_save = 0;
+    save_distance = 1;
+}
+
+bool lc3::core::LoopDetector::check(lc3::core::MachineState const & state, uint64_t phase)
+{
+    if(device_written) {
+        reset();
+    }
+
+    updateMemHash(state);
+    readRegs(state);
+    uint64_t hash = hashWords(FNV_OFFSET ^ phase, regs.data(), regs.size()) ^ mem_hash;
+    if(has_saved && matchesSaved(state, hash, phase)) {
+        return true;
+    }
+
+    // Save the state after 1, 2, 4, ... more checks, so that the distance to the saved state eventually becomes a
+    // multiple of any cycle that the machine is in.
+    checks_since_save += 1;
+    if(! has_saved || checks_since_save == save_distance) {
+        save(state, hash, phase);
+        save_distance = has_saved ? save_distance * 2 : 1;
+        has_saved = true;
+        checks_since_save = 0;
+    }
+    return false;
+}
+
+void lc3::core::LoopDetector::updateMemHash(lc3::core::MachineState const & state)
+{
+    uint16_t words[PAGE_SIZE];
+    for(uint32_t i = 0; i < dirty_pages.size(); i += 1) {
+        for(uint32_t bit = 0; dirty_pages[i] != 0 && bit < 64; bit += 1) {
+            uint32_t page = i * 64 + bit;
+            if(((dirty_pages[i] >> bit) & 1) == 0 || page >= NUM_PAGES) {
+                continue;
+            }
+
+            for(uint32_t j = 0; j < PAGE_SIZE; j += 1) {
+                words[j] = state.peekMem(static_cast<uint16_t>(page * PAGE_SIZE + j));
+            }
+            uint64_t page_hash = hashWords(FNV_OFFSET ^ page, words, PAGE_SIZE);
+            mem_hash ^= page_hashes[page] ^ page_hash;
+            page_hashes[page] = page_hash;
+        }
+        dirty_pages[i] = 0;
+    }
+}
+
+void lc3::core::LoopDetector::readRegs(lc3::core::MachineState const & state)
+{
+    regs.clear();
+    for(uint16_t i = 0; i < 8; i += 1) {
+        regs.push_back(state.readReg(i));
+    }
+    regs.push_back(state.readPC());
+    regs.push_back(state.readSSP());
+    // Includes the PSR and MCR.
+    for(uint32_t addr = MMIO_START; addr <= MMIO_END; addr += 1) {
+        regs.push_back(state.peekMem(static_cast<uint16_t>(addr)));
+    }
+}
+
+bool lc3::core::LoopDetector::matchesSaved(lc3::core::MachineState const & state, uint64_t hash,
+    uint64_t phase) const
+{
+    if(hash != saved.hash || phase != saved.phase || regs != saved.regs) {
+        return false;
+    }
+
+    for(uint32_t addr = 0; addr < saved.mem.size(); addr += 1) {
+        if(state.peekMem(static_cast<uint16_t>(addr)) != saved.mem[addr]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void lc3::core::LoopDetector::save(lc3::core::MachineState const & state, uint64_t hash, uint64_t phase)
+{
+    saved.hash = hash;
+    saved.phase = phase;
+    saved.regs = regs;
+    saved.mem.resize(MMIO_START);
+    for(uint32_t addr = 0; addr < saved.mem.size(); addr += 1) {
+        saved.mem[addr] = state.peekMem(static_cast<uint16_t>(addr));
+    }
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#ifndef LOOP_DETECTOR_H
+#define LOOP_DETECTOR_H
+
+#include <cstdint>
+#include <vector>
+
+#ifndef DEFAULT_LOOP_CHECK_INTERVAL
+    #define DEFAULT_LOOP_CHECK_INTERVAL 1024
+#endif
+
+namespace lc3
+{
+namespace core
+{
+    class MachineState;
+
+    // Recognizes a machine that has stopped making progress. While nothing outside of the machine can change it, the
+    // machine is deterministic, so returning to a state it was in before means it will repeat that cycle forever. The
+    // state is checked periodically by hashing the registers, the device registers, and only the pages of memory that
+    // were written since the previous check; states are compared in full when their hashes match. The state that
+    // later checks are compared against is replaced at doubling distances, so a cycle of any length is found.
+    class LoopDetector
+    {
+    public:
+        static constexpr uint32_t PAGE_SIZE = 64;
+
+        LoopDetector(uint64_t interval);
+
+        // Number of instructions between checks.
+        uint64_t getInterval(void) const { return interval; }
+        void markDirty(uint16_t addr)
+        {
+            uint32_t page = addr / PAGE_SIZE;
+            dirty_pages[page / 64] |= 1ull << (page % 64);
+        }
+        void markAllDirty(void);
+        // Writing a device register has effects outside of the machine (e.g. printing output), so it counts as
+        // progress even if the machine returns to the same state afterwards.
+        void markDeviceWrite(void) { device_written = true; }
+
+        // Forget the saved state, e.g. because something outside of the machine could have changed it.
+        void reset(void);
+        // Returns true if the machine is in the same state as at an earlier check since the last reset. Checks are
+        // only comparable if they were made at the same phase, i.e. number of instructions past a multiple of the
+        // interval.
+        bool check(MachineState const & state, uint64_t phase);
+
+    private:
+        struct Snapshot
+        {
+            uint64_t hash;
+            uint64_t phase;
+            std::vector<uint16_t> regs;
+            std::vector<uint16_t> mem;
+        };
+
+        uint64_t interval;
+
+        // One bit per page of memory.
+        std::vector<uint64_t> dirty_pages;
+        std::vector<uint64_t> page_hashes;
+        // Combination of all of the page hashes.
+        uint64_t mem_hash;
+
+        bool device_written;
+
+        Snapshot saved;
+        bool has_saved;
+        uint64_t checks_since_save, save_distance;
+
+        std::vector<uint16_t> regs;
+
+        void updateMemHash(MachineState const & state);
+        void readRegs(MachineState const & state);
+        bool matchesSaved(MachineState const & state, uint64_t hash, uint64_t phase) const;
+        void save(MachineState const & state, uint64_t hash, uint64_t phase);
+    };
+};
+};
+
+#endif
@@ -0,0 +1,118 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#include "object_sink.h"
+#include "utils.h"
+
+void lc3::core::ObjectStreamSink::begin(void)
+{
+    buffer << lc3::utils::getMagicHeader();
+    buffer << lc3::utils::getVersionString();
+}
+
+void lc3::core::ObjectFileSink::begin(void)
+{
+    file.open(filename, std::ios_base::binary);
+    if(file.is_open()) {
+        file << lc3::utils::getMagicHeader();
+        file << lc3::utils::getVersionString();
+    }
+}
+
+void lc3::core::ObjectFileSink::write(lc3::core::MemLocation const & entry)
+{
+    if(file.is_open()) {
+        file << entry;
+    }
+}
+
+void lc3::core::ObjectMemorySink::replay(lc3::core::IObjectSink & sink) const
+{
+    sink.begin();
+    for(MemLocation const & entry : entries) {
+        sink.write(entry);
+    }
+    sink.end();
+}
+
+void lc3::core::MachineStateSink::begin(void)
+{
+    fill_pc = 0;
+    offset = 0;
+    first_orig_set = false;
+}
+
+void lc3::core::MachineStateSink::write(lc3::core::MemLocation const & entry)
+{
+    if(entry.isOrig()) {
+        if(! first_orig_set) {
+            if(entry.getValue() != 0) {
+                // If orig is 0, then most likely an OS is being loaded.  Don't change the reset PC.
+                state.writeResetPC(entry.getValue());
+            }
+            first_orig_set = true;
+        }
+        fill_pc = entry.getValue();
+        offset = 0;
+    } else {
+        logger.printf(lc3::utils::PrintType::P_DEBUG, true, "0x%0.4x: %s (0x%0.4x)", fill_pc + offset,
+            entry.getLine().c_str(), entry.getValue());
+        state.writeMem(fill_pc + offset, entry.getValue());
+        state.setMemLine(fill_pc + offset, entry.getLine());
+        offset += 1;
+    }
+}
+
+void lc3::core::readObj(std::istream & buffer, lc3::core::IObjectSink & sink, lc3::utils::Logger & logger)
+{
+    using namespace lc3::utils;
+
+    // Verify header.
+    std::string expected_header = lc3::utils::getMagicHeader();
+    char * header = new char[expected_header.size()];
+    if(buffer.read(header, expected_header.size())) {
+        for(uint32_t i = 0; i < expected_header.size(); i += 1) {
+            if(header[i] != expected_header[i]) {
+                delete[] header;
+                logger.printf(PrintType::P_ERROR, true, "invalid header (is this a .obj file?); try re-assembling");
+                throw lc3::utils::exception("invalid header (is this a .obj file?); try re-assembling");
+            }
+        }
+        delete[] header;
+    } else {
+        delete[] header;
+        logger.printf(PrintType::P_ERROR, true, "could not read header");
+        throw lc3::utils::exception("could not read header");
+    }
+
+    // Verify version number matches current version number.
+    std::string expected_version = lc3::utils::getVersionString();
+    char * version = new char[expected_version.size()];
+    if(buffer.read(version, expected_version.size())) {
+        for(uint32_t i = 0; i < expected_version.size(); i += 1) {
+            if(version[i] != expected_version[i]) {
+                delete[] version;
+                logger.printf(PrintType::P_ERROR, true, "mismatched version numbers; try re-assembling");
+                throw lc3::utils::exception("mismatched version numbers; try re-assembling");
+            }
+        }
+        delete[] version;
+    } else {
+        delete[] version;
+        logger.printf(PrintType::P_ERROR, true, "could not read version number; try re-assembling");
+        throw lc3::utils::exception("could not read version number; try re-assembling");
+    }
+
+    sink.begin();
+    while(! buffer.eof()) {
+        MemLocation mem;
+        buffer >> mem;
+
+        if(buffer.eof()) {
+            break;
+        }
+
+        sink.write(mem);
+    }
+    sink.end();
+}
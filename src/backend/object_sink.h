@@ -0,0 +1,100 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#ifndef OBJECT_SINK_H
+#define OBJECT_SINK_H
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "logger.h"
+#include "mem.h"
+#include "state.h"
+
+namespace lc3
+{
+namespace core
+{
+    // Destination for an object. begin() is called once the object is known to be valid, followed by write() for each
+    // entry in order and then end().
+    class IObjectSink
+    {
+    public:
+        virtual ~IObjectSink(void) = default;
+
+        virtual void begin(void) {}
+        virtual void write(MemLocation const & entry) = 0;
+        virtual void end(void) {}
+    };
+
+    // Serializes the object into a stream in the object file format.
+    class ObjectStreamSink : public IObjectSink
+    {
+    public:
+        ObjectStreamSink(std::ostream & buffer) : buffer(buffer) {}
+
+        virtual void begin(void) override;
+        virtual void write(MemLocation const & entry) override { buffer << entry; }
+
+    private:
+        std::ostream & buffer;
+    };
+
+    // Serializes the object into an object file. The file is not touched unless the object is valid.
+    class ObjectFileSink : public IObjectSink
+    {
+    public:
+        ObjectFileSink(std::string const & filename) : filename(filename) {}
+
+        virtual void begin(void) override;
+        virtual void write(MemLocation const & entry) override;
+        virtual void end(void) override { file.close(); }
+
+        bool good(void) const { return file.good(); }
+
+    private:
+        std::string filename;
+        std::ofstream file;
+    };
+
+    // Keeps the object in memory so that it can be loaded any number of times without serializing it.
+    class ObjectMemorySink : public IObjectSink
+    {
+    public:
+        virtual void begin(void) override { entries.clear(); }
+        virtual void write(MemLocation const & entry) override { entries.push_back(entry); }
+
+        std::vector<MemLocation> const & getEntries(void) const { return entries; }
+        void replay(IObjectSink & sink) const;
+
+    private:
+        std::vector<MemLocation> entries;
+    };
+
+    // Places the object into memory, setting the reset PC to the first non-zero origin.
+    class MachineStateSink : public IObjectSink
+    {
+    public:
+        MachineStateSink(MachineState & state, lc3::utils::Logger & logger) :
+            state(state), logger(logger), fill_pc(0), offset(0), first_orig_set(false) {}
+
+        virtual void begin(void) override;
+        virtual void write(MemLocation const & entry) override;
+
+    private:
+        MachineState & state;
+        lc3::utils::Logger & logger;
+
+        uint32_t fill_pc;
+        uint32_t offset;
+        bool first_orig_set;
+    };
+
+    // Reads an object in the object file format from a stream into a sink.
+    void readObj(std::istream & buffer, IObjectSink & sink, lc3::utils::Logger & logger);
+};
+};
+
+#endif
@@ -4,8 +4,21 @@
 #ifndef PRINTER_H
 #define PRINTER_H
 
+#include <cstdint>
 #include <string>
 
+#ifndef DEFAULT_PRINT_BUFFER_SIZE
+    #define DEFAULT_PRINT_BUFFER_SIZE 4096
+#endif
+
+#ifndef DEFAULT_OUTPUT_LIMIT
+    #define DEFAULT_OUTPUT_LIMIT (1 << 20)
+#endif
+
+#ifndef DEFAULT_OUTPUT_LIMIT_MARKER
+    #define DEFAULT_OUTPUT_LIMIT_MARKER "\n[output limit exceeded]\n"
+#endif
+
 namespace lc3
 {
 namespace utils
@@ -43,6 +56,54 @@ namespace utils
         virtual void setColor(PrintColor color) = 0;
         virtual void print(std::string const & string) = 0;
         virtual void newline(void) = 0;
+        // Printers that buffer their output write out everything printed so far. The simulator flushes whenever the
+        // program waits for input and whenever a run stops.
+        virtual void flush(void) {}
+
+        // Printers that keep what they are given (rather than passing it straight through) keep at most limit
+        // characters, replacing the rest with DEFAULT_OUTPUT_LIMIT_MARKER; 0 means no limit. Whether anything was
+        // left out is reported by didExceedOutputLimit until the kept output is cleared.
+        virtual void setOutputLimit(uint64_t limit) { (void) limit; }
+        virtual bool didExceedOutputLimit(void) const { return false; }
+    };
+
+    // Keeps track of how much output a printer has kept against its output limit.
+    class OutputLimiter
+    {
+    public:
+        OutputLimiter(void) : limit(0), kept(0), exceeded(false) {}
+
+        void setLimit(uint64_t limit) { this->limit = limit; }
+        bool didExceed(void) const { return exceeded; }
+        void reset(void)
+        {
+            kept = 0;
+            exceeded = false;
+        }
+
+        // Returns how many characters to keep from the start of the next size characters of output. The first time
+        // any are left out, add_marker is set, and DEFAULT_OUTPUT_LIMIT_MARKER should be kept after them.
+        uint64_t fit(uint64_t size, bool & add_marker)
+        {
+            add_marker = false;
+            if(limit == 0) { return size; }
+            if(exceeded) { return 0; }
+
+            uint64_t remaining = limit > kept ? limit - kept : 0;
+            if(size <= remaining) {
+                kept += size;
+                return size;
+            }
+
+            kept += remaining;
+            exceeded = true;
+            add_marker = true;
+            return remaining;
+        }
+
+    private:
+        uint64_t limit, kept;
+        bool exceeded;
     };
 };
 };
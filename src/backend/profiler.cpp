@@ -0,0 +1,134 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#include <algorithm>
+
+#include "profiler.h"
+#include "utils.h"
+
+static char const * const opcode_names[] = {
+    "BR", "ADD", "LD", "ST", "JSR", "AND", "LDR", "STR", "RTI", "NOT", "LDI", "STI", "JMP", "RESERVED", "LEA", "TRAP"
+};
+
+lc3::core::Profiler::Profiler(void) : addr_counts(1 << 16, 0), opcode_counts(16, 0)
+{
+    reset();
+}
+
+void lc3::core::Profiler::reset(void)
+{
+    std::fill(addr_counts.begin(), addr_counts.end(), 0);
+    std::fill(opcode_counts.begin(), opcode_counts.end(), 0);
+    stacks.clear();
+    stacks.push_back({0, 0, 1});
+    stack_counts.assign(1, 0);
+    stack_ids.clear();
+    cur_stack = 0;
+    next_stack = 0;
+}
+
+void lc3::core::Profiler::enterSubroutine(uint16_t addr, bool immediate)
+{
+    auto search = stack_ids.find(std::make_pair(next_stack, addr));
+    if(search != stack_ids.end()) {
+        next_stack = search->second;
+    } else {
+        uint32_t id = static_cast<uint32_t>(stacks.size());
+        stacks.push_back({addr, next_stack, 0});
+        stack_counts.push_back(0);
+        stack_ids[std::make_pair(next_stack, addr)] = id;
+        next_stack = id;
+    }
+    stacks[next_stack].calls += 1;
+
+    if(immediate) {
+        cur_stack = next_stack;
+    }
+}
+
+void lc3::core::Profiler::exitSubroutine(void)
+{
+    // Returning from the subroutine that was running when profiling began leaves the stack as is.
+    next_stack = stacks[next_stack].parent;
+}
+
+std::vector<lc3::core::SubroutineProfile> lc3::core::Profiler::getSubroutineProfiles(void) const
+{
+    std::map<uint16_t, SubroutineProfile> profiles;
+    std::vector<uint16_t> seen;
+    for(uint32_t id = 1; id < stacks.size(); id += 1) {
+        SubroutineProfile & profile = profiles[stacks[id].addr];
+        profile.addr = stacks[id].addr;
+        profile.calls += stacks[id].calls;
+        profile.exclusive += stack_counts[id];
+
+        // Attribute the instructions to every subroutine on the stack, but only once to a recursive subroutine.
+        seen.clear();
+        for(uint32_t cur = id; cur != 0; cur = stacks[cur].parent) {
+            if(std::find(seen.begin(), seen.end(), stacks[cur].addr) == seen.end()) {
+                seen.push_back(stacks[cur].addr);
+                SubroutineProfile & caller = profiles[stacks[cur].addr];
+                caller.addr = stacks[cur].addr;
+                caller.inclusive += stack_counts[id];
+            }
+        }
+    }
+
+    std::vector<SubroutineProfile> ret;
+    for(auto const & profile : profiles) {
+        ret.push_back(profile.second);
+    }
+    return ret;
+}
+
+std::string lc3::core::Profiler::toJSON(void) const
+{
+    uint64_t total = 0;
+    std::string addrs;
+    for(uint32_t addr = 0; addr < addr_counts.size(); addr += 1) {
+        if(addr_counts[addr] != 0) {
+            total += addr_counts[addr];
+            addrs += lc3::utils::ssprintf("%s{\"addr\":%u,\"count\":%llu}", addrs.empty() ? "" : ",", addr,
+                static_cast<unsigned long long>(addr_counts[addr]));
+        }
+    }
+
+    std::string opcodes;
+    for(uint32_t opcode = 0; opcode < opcode_counts.size(); opcode += 1) {
+        opcodes += lc3::utils::ssprintf("%s\"%s\":%llu", opcode == 0 ? "" : ",", opcode_names[opcode],
+            static_cast<unsigned long long>(opcode_counts[opcode]));
+    }
+
+    std::string subroutines;
+    for(SubroutineProfile const & profile : getSubroutineProfiles()) {
+        subroutines += lc3::utils::ssprintf("%s{\"addr\":%u,\"calls\":%llu,\"inclusive\":%llu,\"exclusive\":%llu}",
+            subroutines.empty() ? "" : ",", profile.addr, static_cast<unsigned long long>(profile.calls),
+            static_cast<unsigned long long>(profile.inclusive), static_cast<unsigned long long>(profile.exclusive));
+    }
+
+    return lc3::utils::ssprintf("{\"instructions\":%llu,\"addresses\":[%s],\"opcodes\":{%s},\"subroutines\":[%s]}",
+        static_cast<unsigned long long>(total), addrs.c_str(), opcodes.c_str(), subroutines.c_str());
+}
+
+std::string lc3::core::Profiler::toFoldedStacks(void) const
+{
+    std::string ret;
+    std::vector<uint16_t> addrs;
+    for(uint32_t id = 0; id < stacks.size(); id += 1) {
+        if(stack_counts[id] == 0) {
+            continue;
+        }
+
+        addrs.clear();
+        for(uint32_t cur = id; cur != 0; cur = stacks[cur].parent) {
+            addrs.push_back(stacks[cur].addr);
+        }
+
+        ret += "main";
+        for(auto it = addrs.rbegin(); it != addrs.rend(); ++it) {
+            ret += lc3::utils::ssprintf(";x%04X", *it);
+        }
+        ret += lc3::utils::ssprintf(" %llu\n", static_cast<unsigned long long>(stack_counts[id]));
+    }
+    return ret;
+}
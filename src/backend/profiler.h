@@ -0,0 +1,80 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace lc3
+{
+namespace core
+{
+    // Instructions executed by a subroutine (including trap, interrupt, and exception handlers), identified by the
+    // address it was entered at.
+    struct SubroutineProfile
+    {
+        uint16_t addr;
+        uint64_t calls;
+        // Instructions executed by the subroutine and everything it called, counting recursive calls only once.
+        uint64_t inclusive;
+        // Instructions executed by the subroutine itself.
+        uint64_t exclusive;
+    };
+
+    // Counts executed instructions per address, per opcode, and per call stack. Counting only indexes into flat
+    // arrays; call stacks are only looked up when a subroutine is entered.
+    class Profiler
+    {
+    public:
+        Profiler(void);
+
+        void reset(void);
+
+        void countInstruction(uint16_t pc, uint16_t inst)
+        {
+            addr_counts[pc] += 1;
+            opcode_counts[inst >> 12] += 1;
+            stack_counts[cur_stack] += 1;
+            cur_stack = next_stack;
+        }
+        // Calls, returns, and exceptions take effect after the instruction that caused them is counted, whereas
+        // interrupts are entered before the next instruction is executed, so they take effect immediately.
+        void enterSubroutine(uint16_t addr, bool immediate);
+        void exitSubroutine(void);
+
+        uint64_t getAddrCount(uint16_t addr) const { return addr_counts[addr]; }
+        uint64_t getOpcodeCount(uint16_t opcode) const { return opcode_counts[opcode & 0xf]; }
+        std::vector<SubroutineProfile> getSubroutineProfiles(void) const;
+
+        std::string toJSON(void) const;
+        // One line per call stack, formatted as "main;x3010;x3050 COUNT", which is the input format of most flame
+        // graph tools.
+        std::string toFoldedStacks(void) const;
+
+    private:
+        // A unique call stack, identified by its innermost subroutine and the stack it was called from.
+        struct Stack
+        {
+            uint16_t addr;
+            uint32_t parent;
+            uint64_t calls;
+        };
+
+        std::vector<uint64_t> addr_counts;
+        std::vector<uint64_t> opcode_counts;
+
+        // Stack 0 is the code that runs outside of any subroutine.
+        std::vector<Stack> stacks;
+        std::vector<uint64_t> stack_counts;
+        std::map<std::pair<uint32_t, uint16_t>, uint32_t> stack_ids;
+        uint32_t cur_stack, next_stack;
+    };
+};
+};
+
+#endif
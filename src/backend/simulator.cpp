@@ -5,6 +5,7 @@
 
 #include <algorithm>
 #include <iostream>
+#include <limits>
 
 #include "decoder.h"
 #include "device_regs.h"
@@ -12,18 +13,17 @@
 using namespace lc3::core;
 
 static constexpr uint64_t INST_TIMESTEP = 20;
+// Skipping is split up so that asynchronous interrupts are still noticed when a loop would poll forever.
+static constexpr uint64_t MAX_POLL_SKIP_ITERATIONS = 1 << 20;
 
 Simulator::Simulator(lc3::utils::IPrinter & printer, lc3::utils::IInputter & inputter, uint32_t print_level) :
-    time(0), logger(printer, print_level)
+    time(0), logger(printer, print_level), keyboard_inputter(*this, inputter), total_inst_count(0), inst_charge(1),
+    native_traps(false), native_trap_charge(1), poll_skipping(false), run_inst_limit(0), next_loop_check(0),
+    detected_loop(false), stop_on_output_limit(false), session_active(false), replay_remaining(0)
 {
-    devices.emplace_back(std::make_shared<KeyboardDevice>(inputter));
-    devices.emplace_back(std::make_shared<DisplayDevice>(logger));
-
-    for(PIDevice dev : devices) {
-        for(uint16_t dev_addr : dev->getAddrMap()) {
-            state.registerDeviceReg(dev_addr, dev);
-        }
-    }
+    registerDevice(std::make_shared<KeyboardDevice>(keyboard_inputter));
+    registerDevice(std::make_shared<DisplayDevice>(logger));
+    registerDevice(std::make_shared<TimerDevice>(*this));
 
     setup(0);
 }
@@ -34,16 +34,40 @@ void Simulator::simulate(void)
     inst_count_this_run = 0;
     async_interrupt = false;
 
-    sim::Decoder decoder;
-
     // Initialize devices.
-    for(PIDevice dev : devices) {
-        dev->startup();
+    if(! session_active) {
+        for(PIDevice dev : devices) {
+            dev->startup();
+        }
+    }
+
+    if(tracer != nullptr && replay_remaining == 0) {
+        tracer->sync(state);
+    }
+    if(history != nullptr) {
+        history->begin(state, stack_trace, mem_writes);
+    }
+    mem_writes.clear();
+
+    // Input may have been changed since the previous run, so states from that run can't be compared against.
+    detected_loop = false;
+    if(loop_detector != nullptr) {
+        loop_detector->reset();
+        next_loop_check = total_inst_count + loop_detector->getInterval();
     }
 
     do {
         handleDevices();
-        handleInstruction(decoder);
+        if(! skipPollingLoop()) {
+            handleInstruction(decoder);
+        }
+        if(loop_detector != nullptr && total_inst_count >= next_loop_check && replay_remaining == 0) {
+            checkForLoop();
+        }
+        if(stop_on_output_limit && logger.getPrinter().didExceedOutputLimit()) {
+            triggerSuspend();
+            executeEvents();
+        }
     } while(lc3::utils::getBit(state.readMCR(), 15) == 1 && ! async_interrupt);
     // While this loop is running, async_interrupt will only be read by this thread.  It may be written by another
     // thread, such as in the context of a GUI running the simulator asynchronously, but even then there will only
@@ -52,9 +76,40 @@ void Simulator::simulate(void)
     async_interrupt = false;
 
     // Shutdown devices.
+    if(! session_active) {
+        for(PIDevice dev : devices) {
+            dev->shutdown();
+        }
+    }
+
+    // Make sure the trace is complete whenever the simulator is not running.
+    if(tracer != nullptr) {
+        tracer->flush();
+    }
+}
+
+void Simulator::beginSession(void)
+{
+    if(session_active) {
+        return;
+    }
+
+    for(PIDevice dev : devices) {
+        dev->startup();
+    }
+    session_active = true;
+}
+
+void Simulator::endSession(void)
+{
+    if(! session_active) {
+        return;
+    }
+
     for(PIDevice dev : devices) {
         dev->shutdown();
     }
+    session_active = false;
 }
 
 void Simulator::loadObj(std::string const & name, std::istream & buffer)
@@ -74,6 +129,12 @@ void Simulator::setup(uint64_t t_delta)
 void Simulator::reinitialize(void)
 {
     state.reinitialize();
+    if(framebuffer != nullptr) {
+        framebuffer->markAllDirty();
+    }
+    if(loop_detector != nullptr) {
+        loop_detector->markAllDirty();
+    }
 }
 
 void Simulator::triggerSuspend()
@@ -87,6 +148,34 @@ void Simulator::registerCallback(CallbackType type, Callback func)
     callbacks[type] = func;
 }
 
+bool Simulator::registerDevice(PIDevice device)
+{
+    std::vector<uint16_t> addrs = device->getAddrMap();
+    for(uint16_t addr : addrs) {
+        if(addr < MMIO_START || state.getDeviceReg(addr) != nullptr) {
+            return false;
+        }
+    }
+
+    for(uint16_t addr : addrs) {
+        state.registerDeviceReg(addr, device);
+    }
+    devices.push_back(device);
+    if(device->needsTick()) {
+        ticked_devices.push_back(device);
+    }
+    if(session_active) {
+        device->startup();
+    }
+
+    return true;
+}
+
+void Simulator::scheduleTick(uint64_t inst_count, PIDevice device)
+{
+    scheduled_ticks.emplace(inst_count, device);
+}
+
 void Simulator::addBreakpoint(uint16_t pc)
 {
     breakpoints.insert(pc);
@@ -138,9 +227,17 @@ void Simulator::handleDevices(void)
     uint64_t fetch_time_offset = INST_TIMESTEP - (time % INST_TIMESTEP);
 
     // Insert device update events.
-    for(PIDevice dev : devices) {
+    for(PIDevice const & dev : ticked_devices) {
         events.emplace(std::make_shared<DeviceUpdateEvent>(time + fetch_time_offset - 10, dev));
     }
+    while(! scheduled_ticks.empty() && scheduled_ticks.top().first <= total_inst_count) {
+        events.emplace(std::make_shared<DeviceUpdateEvent>(time + fetch_time_offset - 10,
+            scheduled_ticks.top().second));
+        scheduled_ticks.pop();
+        if(history != nullptr) {
+            history->markDeviceEvent();
+        }
+    }
 
     // Check for interrupts triggered by devices.
     events.emplace(std::make_shared<CheckForInterruptEvent>(time + fetch_time_offset - 9));
@@ -165,7 +262,22 @@ void Simulator::handleInstruction(sim::Decoder & decoder)
         handleCallbacks(fetch_time_offset);
 
         // Insert instruction fetch event.
-        events.emplace(std::make_shared<AtomicInstProcessEvent>(time + fetch_time_offset, decoder));
+        inst_charge = 1;
+        if(native_traps && isNativeTrap(state.readPC())) {
+            // Traps performed directly read and write the devices without going through their registers.
+            if(loop_detector != nullptr) {
+                loop_detector->markDeviceWrite();
+            }
+            // GETC and IN take a key from the keyboard.
+            uint16_t vector = state.peekMem(state.readPC()) & 0x00FF;
+            if(history != nullptr && (vector == 0x20 || vector == 0x23)) {
+                history->markDeviceEvent();
+            }
+            events.emplace(std::make_shared<NativeTrapEvent>(time + fetch_time_offset, decoder, native_trap_charge,
+                inst_charge));
+        } else {
+            events.emplace(std::make_shared<AtomicInstProcessEvent>(time + fetch_time_offset, decoder));
+        }
         executeEvents();
 
         // Insert post-instruction callback and any other callbacks generated during execution.
@@ -176,6 +288,120 @@ void Simulator::handleInstruction(sim::Decoder & decoder)
     }
 }
 
+bool Simulator::isNativeTrap(uint16_t pc) const
+{
+    uint16_t inst = state.peekMem(pc);
+    if((inst & 0xFF00) != 0xF000 || (inst & 0x00FF) < 0x20 || (inst & 0x00FF) > 0x25 || os_traps.empty()) {
+        return false;
+    }
+
+    std::pair<uint16_t, uint16_t> const & os_trap = os_traps[(inst & 0x00FF) - 0x20];
+    return state.peekMem(inst & 0x00FF) == os_trap.first && state.peekMem(os_trap.first) == os_trap.second;
+}
+
+bool Simulator::skipPollingLoop(void)
+{
+    if(! poll_skipping || profiler != nullptr || tracer != nullptr || history != nullptr ||
+        ! state.getPendingCallbacks().empty())
+    {
+        return false;
+    }
+
+    // Look for "LDI Rx, ptr" followed by a BR back to the LDI, where ptr holds the address of a status register.
+    uint16_t pc = state.readPC();
+    uint16_t ldi = state.peekMem(pc);
+    uint16_t br = state.peekMem(pc + 1);
+    if((ldi & 0xF000) != 0xA000 || (br & 0xF1FF) != 0x01FE || (br & 0x0E00) == 0 || hasBreakpoint(pc) ||
+        hasBreakpoint(pc + 1))
+    {
+        return false;
+    }
+
+    uint16_t ptr = pc + 1 + lc3::utils::sextTo16(ldi & 0x01FF, 9);
+    uint16_t addr = state.peekMem(ptr);
+    if(ptr >= MMIO_START || (addr != KBSR && addr != DSR && addr != TMCR) || isAccessViolation(pc, state) ||
+        isAccessViolation(pc + 1, state) || isAccessViolation(ptr, state) || isAccessViolation(addr, state))
+    {
+        return false;
+    }
+
+    // The loop only continues if the branch is taken for the status that was loaded.
+    uint16_t value = state.peekMem(addr);
+    uint16_t cc = lc3::utils::getBit(value, 15) == 1 ? 0x0004 : (value == 0 ? 0x0002 : 0x0001);
+    if((((br >> 9) & 0x7) & cc) == 0) {
+        return false;
+    }
+
+    uint64_t idle_ticks = std::numeric_limits<uint64_t>::max();
+    for(PIDevice const & dev : ticked_devices) {
+        idle_ticks = std::min(idle_ticks, dev->getIdleTicks());
+    }
+    if(! scheduled_ticks.empty()) {
+        idle_ticks = std::min(idle_ticks, scheduled_ticks.top().first - total_inst_count - 1);
+    }
+
+    // Each iteration is two instructions, and the devices have already been ticked for the first one.
+    uint64_t iterations = std::min(idle_ticks / 2 + idle_ticks % 2, MAX_POLL_SKIP_ITERATIONS);
+    if(run_inst_limit != 0) {
+        iterations = std::min(iterations,
+            inst_count_this_run < run_inst_limit ? (run_inst_limit - inst_count_this_run) / 2 : 0);
+    }
+    if(iterations == 0) {
+        return false;
+    }
+
+    uint64_t fetch_time_offset = INST_TIMESTEP - (time % INST_TIMESTEP);
+    triggerCallback(fetch_time_offset, CallbackType::PRE_INST);
+    executeEvents();
+    if(lc3::utils::getBit(state.readMCR(), 15) == 0) {
+        return true;
+    }
+
+    logger.printf(lc3::utils::PrintType::P_EXTRA, true, "%d: Skipping %d iterations of polling loop at 0x%0.4hx",
+        time, iterations, pc);
+    logger.newline(lc3::utils::PrintType::P_EXTRA);
+
+    for(PIDevice const & dev : ticked_devices) {
+        dev->skipTicks(2 * iterations - 1);
+    }
+    state.writeReg((ldi >> 9) & 0x7, value);
+    state.writePSR((state.readPSR() & 0xFFF8) | cc);
+    state.writeIR(br);
+    time += (2 * iterations - 1) * INST_TIMESTEP;
+
+    inst_charge = 2 * iterations;
+    triggerCallback(0, CallbackType::POST_INST);
+    executeEvents();
+    return true;
+}
+
+void Simulator::checkForLoop(void)
+{
+    // Instructions that count as more than one can step over a check, so the phase of each check is kept.
+    uint64_t interval = loop_detector->getInterval();
+    uint64_t phase = (total_inst_count - next_loop_check) % interval;
+    next_loop_check = total_inst_count - phase + interval;
+
+    // The machine is only deterministic if no device can ever change on its own again.
+    bool idle = scheduled_ticks.empty() && ! state.hasPendingInterrupt();
+    for(PIDevice const & dev : ticked_devices) {
+        idle = idle && dev->getIdleTicks() == std::numeric_limits<uint64_t>::max();
+    }
+    if(! idle) {
+        loop_detector->reset();
+        return;
+    }
+
+    if(loop_detector->check(state, phase)) {
+        logger.printf(lc3::utils::PrintType::P_DEBUG, true, "Machine stopped making progress at 0x%0.4hx",
+            state.readPC());
+        logger.newline(lc3::utils::PrintType::P_DEBUG);
+        detected_loop = true;
+        triggerSuspend();
+        executeEvents();
+    }
+}
+
 void Simulator::handleCallbacks(uint64_t t_delta)
 {
     // Insert callback events that might have been generated during execution.
@@ -195,9 +421,36 @@ void Simulator::triggerCallback(uint64_t t_delta, CallbackType type)
 
 void Simulator::callbackDispatcher(Simulator * sim, CallbackType type, MachineState & state)
 {
+    // Re-executed instructions already ran once, so only the history is rebuilt and nothing else observes them.
+    if(sim->replay_remaining != 0) {
+        if(type == CallbackType::PRE_INST) {
+            sim->pre_inst_pc = state.readPC();
+        } else if(type == CallbackType::SUB_ENTER || type == CallbackType::EX_ENTER ||
+            type == CallbackType::INT_ENTER)
+        {
+            sim->stack_trace.push_back(sim->pre_inst_pc);
+        } else if(type == CallbackType::SUB_EXIT || type == CallbackType::EX_EXIT ||
+            type == CallbackType::INT_EXIT)
+        {
+            sim->stack_trace.pop_back();
+        } else if(type == CallbackType::POST_INST) {
+            ++(sim->total_inst_count);
+            sim->history->recordInstruction(state, sim->stack_trace, sim->mem_writes);
+            sim->mem_writes.clear();
+            sim->replay_remaining -= 1;
+            if(sim->replay_remaining == 0) {
+                sim->triggerSuspend();
+            }
+        }
+        return;
+    }
+
     if(type == CallbackType::PRE_INST) {
         sim->pre_inst_pc = state.readPC();
     } else if(type == CallbackType::SUB_ENTER || type == CallbackType::EX_ENTER || type == CallbackType::INT_ENTER) {
+        if(sim->profiler != nullptr) {
+            sim->profiler->enterSubroutine(state.readPC(), type == CallbackType::INT_ENTER);
+        }
         sim->stack_trace.push_back(sim->pre_inst_pc);
         sim->logger.printf(lc3::utils::PrintType::P_DEBUG, true, "Stack trace");
         for(int64_t i = sim->stack_trace.size() - 1; i >= 0; --i) {
@@ -206,6 +459,9 @@ void Simulator::callbackDispatcher(Simulator * sim, CallbackType type, MachineSt
                 sim->stack_trace.size() - 1 - i, pc, state.getMemLine(pc).c_str());
         }
     } else if(type == CallbackType::SUB_EXIT || type == CallbackType::EX_EXIT || type == CallbackType::INT_EXIT) {
+        if(sim->profiler != nullptr) {
+            sim->profiler->exitSubroutine();
+        }
         sim->stack_trace.pop_back();
         sim->logger.printf(lc3::utils::PrintType::P_DEBUG, true, "Stack trace");
         for(int64_t i = sim->stack_trace.size() - 1; i >= 0; --i) {
@@ -214,7 +470,21 @@ void Simulator::callbackDispatcher(Simulator * sim, CallbackType type, MachineSt
                 sim->stack_trace.size() - 1 - i, pc, state.getMemLine(pc).c_str());
         }
     } else if(type == CallbackType::POST_INST) {
-        ++(sim->inst_count_this_run);
+        sim->inst_count_this_run += sim->inst_charge;
+        sim->total_inst_count += sim->inst_charge;
+        if(sim->profiler != nullptr || sim->tracer != nullptr) {
+            uint16_t inst = state.peekMem(sim->pre_inst_pc);
+            if(sim->profiler != nullptr) {
+                sim->profiler->countInstruction(sim->pre_inst_pc, inst);
+            }
+            if(sim->tracer != nullptr) {
+                sim->tracer->recordInstruction(state, sim->pre_inst_pc, inst, sim->mem_writes);
+            }
+        }
+        if(sim->history != nullptr) {
+            sim->history->recordInstruction(state, sim->stack_trace, sim->mem_writes);
+        }
+        sim->mem_writes.clear();
     }
 
     auto search = sim->callbacks.find(type);
@@ -227,3 +497,175 @@ MachineState & Simulator::getMachineState(void) { return state; }
 MachineState const & Simulator::getMachineState(void) const { return state; }
 void Simulator::setPrintLevel(uint32_t print_level) { logger.setPrintLevel(print_level); }
 void Simulator::setIgnorePrivilege(bool ignore_privilege) { state.setIgnorePrivilege(ignore_privilege); }
+
+void Simulator::setEnableProfiler(bool enable)
+{
+    if(! enable) {
+        profiler = nullptr;
+    } else if(profiler == nullptr) {
+        profiler = std::make_shared<Profiler>();
+    }
+}
+
+bool Simulator::startTrace(std::string const & filename)
+{
+    stopTrace();
+
+    std::shared_ptr<TraceRecorder> new_tracer = std::make_shared<TraceRecorder>(filename);
+    if(! new_tracer->good()) {
+        logger.printf(lc3::utils::PrintType::P_ERROR, true, "could not open %s for writing", filename.c_str());
+        logger.newline();
+        return false;
+    }
+
+    tracer = new_tracer;
+    updateMemWriteLog();
+    return true;
+}
+
+void Simulator::stopTrace(void)
+{
+    tracer = nullptr;
+    updateMemWriteLog();
+}
+
+void Simulator::setEnableNativeTraps(bool enable, uint64_t inst_charge)
+{
+    native_traps = enable;
+    native_trap_charge = std::max<uint64_t>(inst_charge, 1);
+}
+
+void Simulator::recordOSTraps(void)
+{
+    os_traps.clear();
+    for(uint16_t vec = 0x20; vec <= 0x25; vec += 1) {
+        uint16_t addr = state.peekMem(vec);
+        os_traps.emplace_back(addr, state.peekMem(addr));
+    }
+}
+
+void Simulator::setEnableFramebuffer(bool enable)
+{
+    if(! enable) {
+        framebuffer = nullptr;
+    } else if(framebuffer == nullptr) {
+        framebuffer = std::make_shared<Framebuffer>();
+    }
+    state.setFramebuffer(framebuffer.get());
+}
+
+void Simulator::setEnableLoopDetection(bool enable, uint64_t interval)
+{
+    if(! enable) {
+        loop_detector = nullptr;
+    } else {
+        loop_detector = std::make_shared<LoopDetector>(interval);
+    }
+    state.setLoopDetector(loop_detector.get());
+}
+
+void Simulator::setEnableHistory(bool enable, uint64_t max_size, uint64_t checkpoint_interval)
+{
+    if(! enable) {
+        history = nullptr;
+    } else {
+        history = std::make_shared<History>(max_size, checkpoint_interval);
+    }
+    updateMemWriteLog();
+}
+
+uint64_t Simulator::stepBack(uint64_t count)
+{
+    if(history == nullptr) {
+        return 0;
+    }
+
+    uint64_t start = history->getPosition();
+    uint64_t target = start - std::min(count, start - getOldestReachable());
+    rewind(target);
+    return start - history->getPosition();
+}
+
+uint64_t Simulator::reverseContinue(void)
+{
+    if(history == nullptr) {
+        return 0;
+    }
+
+    uint64_t start = history->getPosition();
+    while(history->getPosition() > getOldestReachable()) {
+        rewind(history->getPosition() - 1);
+        if(breakpoints.find(state.readPC()) != breakpoints.end()) {
+            break;
+        }
+    }
+    return start - history->getPosition();
+}
+
+void Simulator::updateMemWriteLog(void)
+{
+    mem_writes.clear();
+    state.setMemWriteLog(tracer != nullptr || history != nullptr ? &mem_writes : nullptr);
+}
+
+uint64_t Simulator::getOldestReachable(void) const
+{
+    // Only the timer schedules ticks, and it expires at a fixed instruction count.
+    return scheduled_ticks.empty() ? history->getOldestPosition() : history->getUndoStart();
+}
+
+void Simulator::rewind(uint64_t target)
+{
+    // Instructions that are no longer in the undo log are re-executed from the closest checkpoint before them, which
+    // also refills the undo log so that stepping back further is cheap again.
+    if(target < history->getUndoStart() && history->restoreCheckpoint(target, state, stack_trace)) {
+        mem_writes.clear();
+        replay(target - history->getPosition());
+    }
+
+    while(history->getPosition() > target && history->undo(state, stack_trace)) {}
+    mem_writes.clear();
+}
+
+void Simulator::replay(uint64_t count)
+{
+    if(count == 0) {
+        return;
+    }
+
+    // The instructions already printed their output once, and breakpoints must not end the replay early. They were
+    // also already counted, and undoing instructions doesn't uncount them either.
+    uint32_t print_level = logger.getPrintLevel();
+    std::set<uint16_t> saved_breakpoints;
+    uint64_t inst_count = total_inst_count;
+    logger.setPrintLevel(0);
+    std::swap(breakpoints, saved_breakpoints);
+
+    replay_remaining = count;
+    try {
+        simulate();
+    } catch(lc3::utils::exception const &) {
+        replay_remaining = 0;
+        total_inst_count = inst_count;
+        std::swap(breakpoints, saved_breakpoints);
+        logger.setPrintLevel(print_level);
+        throw;
+    }
+    replay_remaining = 0;
+    total_inst_count = inst_count;
+
+    std::swap(breakpoints, saved_breakpoints);
+    logger.setPrintLevel(print_level);
+}
+
+bool SimulatorInputter::getChar(char & c)
+{
+    if(simulator.replay_remaining != 0 || ! inputter.getChar(c)) {
+        return false;
+    }
+
+    if(simulator.history != nullptr) {
+        simulator.history->markDeviceEvent();
+    }
+    return true;
+}
@@ -11,9 +11,15 @@
 
 #include "inputter.h"
 #include "event.h"
+#include "framebuffer.h"
+#include "history.h"
 #include "logger.h"
+#include "loop_detector.h"
+#include "object_sink.h"
 #include "printer.h"
+#include "profiler.h"
 #include "state.h"
+#include "trace.h"
 
 namespace std
 {
@@ -32,12 +38,35 @@ namespace lc3
 {
 namespace core
 {
-    class Simulator
+    class Simulator;
+
+    // Passes input on to the keyboard, except while instructions are re-executed from a history checkpoint: no input
+    // was delivered during them the first time either, so any input that arrived since is left for later.
+    class SimulatorInputter : public lc3::utils::IInputter
+    {
+    public:
+        SimulatorInputter(Simulator & simulator, lc3::utils::IInputter & inputter) :
+            simulator(simulator), inputter(inputter) {}
+
+        virtual void beginInput(void) override { inputter.beginInput(); }
+        virtual bool getChar(char & c) override;
+        virtual void endInput(void) override { inputter.endInput(); }
+        virtual bool hasRemaining(void) const override { return inputter.hasRemaining(); }
+        virtual uint64_t getIdleCount(void) const override { return inputter.getIdleCount(); }
+        virtual void skipIdle(uint64_t count) override { inputter.skipIdle(count); }
+
+    private:
+        Simulator & simulator;
+        lc3::utils::IInputter & inputter;
+    };
+
+    class Simulator : public IDeviceScheduler
     {
     public:
         using Callback = std::function<void(CallbackType, MachineState &)>;
 
         Simulator(lc3::utils::IPrinter & printer, lc3::utils::IInputter & inputter, uint32_t print_level);
+        ~Simulator(void) { endSession(); }
         void simulate(void);
         void loadObj(std::string const & name, std::istream & buffer);
         void setup(uint64_t t_delta = 0);
@@ -46,38 +75,154 @@ namespace core
         void registerCallback(CallbackType type, Callback func);
         void addBreakpoint(uint16_t pc);
         void removeBreakpoint(uint16_t pc);
+        bool hasBreakpoint(uint16_t pc) const { return breakpoints.find(pc) != breakpoints.end(); }
         MachineState & getMachineState(void);
         MachineState const & getMachineState(void) const;
         void asyncInterrupt(void) { async_interrupt = true; }
 
+        // Map each of the device's registers into memory and start updating the device. Returns false, without
+        // registering anything, if a register is outside of xFE00-xFFFF or belongs to another device.
+        bool registerDevice(PIDevice device);
+
+        virtual uint64_t getInstCount(void) const override { return total_inst_count; }
+        virtual void scheduleTick(uint64_t inst_count, PIDevice device) override;
+
         void setPrintLevel(uint32_t print_level);
         void setIgnorePrivilege(bool ignore_privilege);
 
+        // The profiler is only allocated, and instructions are only counted, while profiling is enabled.
+        void setEnableProfiler(bool enable);
+        Profiler * getProfiler(void) { return profiler.get(); }
+        Profiler const * getProfiler(void) const { return profiler.get(); }
+
+        // Record the effects of every executed instruction to a binary trace file until the trace is stopped.
+        bool startTrace(std::string const & filename);
+        void stopTrace(void);
+
+        // Perform TRAP x20-x25 directly instead of running the OS routines, as long as the trap vector table and the
+        // routines are those of the OS that was loaded by the most recent call to recordOSTraps. Each trap performed
+        // directly counts as inst_charge instructions.
+        void setEnableNativeTraps(bool enable, uint64_t inst_charge);
+        void recordOSTraps(void);
+        // Number of instructions the most recently executed instruction counts as.
+        uint64_t getInstCharge(void) const { return inst_charge; }
+
+        // Fast-forward loops that only poll a device's status register (an LDI of KBSR, DSR, or TMCR followed by a BR
+        // back to the LDI) for as long as no device can change, leaving the machine and the instruction counts exactly
+        // as executing the loop would have. A single PRE_INST and POST_INST callback is made for all of the skipped
+        // iterations, and getInstCharge reports how many instructions they were. Loops are never skipped while
+        // profiling, tracing, or keeping history.
+        void setEnablePollSkipping(bool enable) { poll_skipping = enable; }
+        // Skipping never takes the current run past inst_limit instructions (0 means no limit).
+        void setRunInstLimit(uint64_t inst_limit) { run_inst_limit = inst_limit; }
+
+        // Stop running once the machine returns to a state it was already in while no device or input could change
+        // it, which means it would repeat forever. The state is checked every interval instructions.
+        void setEnableLoopDetection(bool enable, uint64_t interval);
+        // Whether the most recent run was stopped because the machine stopped making progress.
+        bool didDetectLoop(void) const { return detected_loop; }
+
+        // Start the devices once for every run until endSession, rather than at the start of each run and stopping
+        // them at its end, so that a run of a single instruction costs about as much as an instruction of a longer
+        // run. A device that is registered during a session is started right away.
+        void beginSession(void);
+        void endSession(void);
+        bool isSessionActive(void) const { return session_active; }
+
+        // Suspend the machine once the printer reports that it left output out because of its output limit.
+        void setStopOnOutputLimit(bool enable) { stop_on_output_limit = enable; }
+
+        // Track which pixels of video memory are written.
+        void setEnableFramebuffer(bool enable);
+        Framebuffer * getFramebuffer(void) { return framebuffer.get(); }
+
+        // Remember executed instructions so that they can be undone, using at most max_size bytes.
+        void setEnableHistory(bool enable, uint64_t max_size, uint64_t checkpoint_interval);
+        bool isHistoryEnabled(void) const { return history != nullptr; }
+        // Both return the number of instructions that were undone, which is less than requested once the oldest
+        // remembered instruction is reached. Only the undo log is used while the timer is running, since
+        // re-executing instructions would move its expiry.
+        uint64_t stepBack(uint64_t count);
+        // Step back until the PC is at a breakpoint.
+        uint64_t reverseContinue(void);
+
     private:
         std::priority_queue<PIEvent, std::vector<PIEvent>, std::greater<PIEvent>> events;
         uint64_t time;
 
         MachineState state;
         std::vector<PIDevice> devices;
+        // The devices that are updated before every instruction.
+        std::vector<PIDevice> ticked_devices;
+        std::priority_queue<std::pair<uint64_t, PIDevice>, std::vector<std::pair<uint64_t, PIDevice>>,
+            std::greater<std::pair<uint64_t, PIDevice>>> scheduled_ticks;
 
         lc3::utils::Logger logger;
+        SimulatorInputter keyboard_inputter;
 
         std::unordered_map<CallbackType, Callback> callbacks;
         std::set<uint16_t> breakpoints;
 
-        uint64_t inst_count_this_run;
+        uint64_t inst_count_this_run, total_inst_count;
         uint16_t pre_inst_pc;
+        uint64_t inst_charge;
+        bool native_traps;
+        uint64_t native_trap_charge;
+        // The address and first instruction of each OS trap routine, indexed by vector - 0x20.
+        std::vector<std::pair<uint16_t, uint16_t>> os_traps;
+        bool poll_skipping;
+        uint64_t run_inst_limit;
         std::vector<uint16_t> stack_trace;
         bool async_interrupt;
+        std::shared_ptr<Profiler> profiler;
+        std::shared_ptr<TraceRecorder> tracer;
+        std::shared_ptr<History> history;
+        std::shared_ptr<Framebuffer> framebuffer;
+        std::shared_ptr<LoopDetector> loop_detector;
+        uint64_t next_loop_check;
+        bool detected_loop;
+        bool stop_on_output_limit;
+        bool session_active;
+        // Decoding tables are built once rather than for every run.
+        sim::Decoder decoder;
+        // Memory written by the current instruction, which is only collected while tracing or keeping history.
+        std::vector<MemWrite> mem_writes;
+        // Instructions left to re-execute while rebuilding the history from a checkpoint.
+        uint64_t replay_remaining;
 
         void powerOn(uint64_t t_delta);
         void executeEvents(void);
         void handleDevices(void);
         void handleInstruction(sim::Decoder & decoder);
+        bool isNativeTrap(uint16_t pc) const;
+        bool skipPollingLoop(void);
+        void checkForLoop(void);
         void handleCallbacks(uint64_t t_delta);
         void triggerCallback(uint64_t t_delta, CallbackType type);
+        void updateMemWriteLog(void);
+        uint64_t getOldestReachable(void) const;
+        void rewind(uint64_t target);
+        void replay(uint64_t count);
 
         static void callbackDispatcher(Simulator * sim, CallbackType type, MachineState & state);
+
+        friend class SimulatorSink;
+        friend class SimulatorInputter;
+    };
+
+    // Loads an object directly into the simulator, exactly as Simulator::loadObj would load the equivalent object file.
+    class SimulatorSink : public IObjectSink
+    {
+    public:
+        SimulatorSink(Simulator & simulator) : simulator(simulator), sink(simulator.state, simulator.logger) {}
+
+        virtual void begin(void) override { sink.begin(); }
+        virtual void write(MemLocation const & entry) override { sink.write(entry); }
+        virtual void end(void) override { simulator.setup(2); }
+
+    private:
+        Simulator & simulator;
+        MachineStateSink sink;
     };
 };
 };
@@ -0,0 +1,65 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace lc3
+{
+namespace utils
+{
+    // Bounded lock-free queue between exactly one producer thread and exactly one consumer thread.
+    template<typename T>
+    class SPSCQueue
+    {
+    public:
+        SPSCQueue(size_t capacity) : slots(capacity + 1), head(0), tail(0) {}
+        SPSCQueue(SPSCQueue const &) = delete;
+        SPSCQueue & operator=(SPSCQueue const &) = delete;
+
+        // Producer only. Returns false, leaving value untouched, if the queue is full.
+        bool push(T && value)
+        {
+            size_t cur_tail = tail.load(std::memory_order_relaxed);
+            size_t next_tail = advance(cur_tail);
+            if(next_tail == head.load(std::memory_order_acquire)) {
+                return false;
+            }
+            slots[cur_tail] = std::move(value);
+            tail.store(next_tail, std::memory_order_release);
+            return true;
+        }
+
+        // Producer only.
+        bool full(void) const
+        {
+            return advance(tail.load(std::memory_order_relaxed)) == head.load(std::memory_order_acquire);
+        }
+
+        // Consumer only. Returns false if the queue is empty.
+        bool pop(T & value)
+        {
+            size_t cur_head = head.load(std::memory_order_relaxed);
+            if(cur_head == tail.load(std::memory_order_acquire)) {
+                return false;
+            }
+            value = std::move(slots[cur_head]);
+            head.store(advance(cur_head), std::memory_order_release);
+            return true;
+        }
+
+    private:
+        std::vector<T> slots;
+        std::atomic<size_t> head, tail;
+
+        size_t advance(size_t idx) const { return idx + 1 == slots.size() ? 0 : idx + 1; }
+    };
+};
+};
+
+#endif
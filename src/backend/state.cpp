@@ -8,8 +8,12 @@
 using namespace lc3::core;
 
 MachineState::MachineState(void) : reset_pc(RESET_PC), pc(0), ir(0), decoded_ir(nullptr), ssp(0),
-    ignore_privilege(false), first_init(true)
+    ignore_privilege(false), first_init(true), mem_write_log(nullptr), framebuffer(nullptr),
+    loop_detector(nullptr)
 {
+    mmio.resize(MMIO_END - MMIO_START + 1);
+    mmio_snapshot.resize(MMIO_END - MMIO_START + 1);
+
     reinitialize();
 
     registerDeviceReg(PSR, std::make_shared<RWReg>(PSR));
@@ -26,6 +30,9 @@ void MachineState::reinitialize(void)
 
     rf.clear();
     rf.resize(16);
+
+    // All of memory was just cleared.
+    dirty_pages.assign((MMIO_END + 1) / DIRTY_PAGE_SIZE / 64, ~0ull);
 }
 
 void MachineState::setIgnorePrivilege(bool ignore_privilege) { this->ignore_privilege = ignore_privilege; }
@@ -34,9 +41,9 @@ bool MachineState::getIgnorePrivilege(void) const { return ignore_privilege; }
 std::pair<uint16_t, PIMicroOp> MachineState::readMem(uint16_t addr) const
 {
     if(MMIO_START <= addr && addr <= MMIO_END) {
-        auto search = mmio.find(addr);
-        if(search != mmio.end()) {
-            return search->second->read(addr);
+        PIDevice const & device = mmio[addr - MMIO_START];
+        if(device != nullptr) {
+            return device->read(addr);
         } else {
             return std::make_pair(0x0000, nullptr);
         }
@@ -45,15 +52,43 @@ std::pair<uint16_t, PIMicroOp> MachineState::readMem(uint16_t addr) const
     }
 }
 
+uint16_t MachineState::peekMem(uint16_t addr) const
+{
+    if(MMIO_START <= addr && addr <= MMIO_END) {
+        PIDevice const & device = mmio[addr - MMIO_START];
+        if(device != nullptr) {
+            return device->peek(addr);
+        } else {
+            return 0x0000;
+        }
+    } else {
+        return mem[addr].getValue();
+    }
+}
+
 PIMicroOp MachineState::writeMem(uint16_t addr, uint16_t value)
 {
+    if(mem_write_log != nullptr) {
+        mem_write_log->push_back({addr, peekMem(addr), value});
+    }
+
     if(MMIO_START <= addr && addr <= MMIO_END) {
-        auto search = mmio.find(addr);
-        if(search != mmio.end()) {
-            return search->second->write(addr, value);
+        PIDevice const & device = mmio[addr - MMIO_START];
+        if(loop_detector != nullptr && addr != PSR && addr != MCR) {
+            loop_detector->markDeviceWrite();
+        }
+        if(device != nullptr) {
+            return device->write(addr, value);
         }
     } else {
         mem[addr].setValue(value);
+        markDirty(addr);
+        if(framebuffer != nullptr && Framebuffer::contains(addr)) {
+            framebuffer->markDirty(addr);
+        }
+        if(loop_detector != nullptr) {
+            loop_detector->markDirty(addr);
+        }
     }
 
     return nullptr;
@@ -72,32 +107,83 @@ void MachineState::setMemLine(uint16_t addr, std::string const & value)
 {
     if(addr < MMIO_START) {
         mem[addr].setLine(value);
+        markDirty(addr);
     }
 }
 
 void MachineState::registerDeviceReg(uint16_t mem_addr, PIDevice device)
 {
-    mmio[mem_addr] = device;
+    mmio[mem_addr - MMIO_START] = device;
+}
+
+PIDevice MachineState::getDeviceReg(uint16_t mem_addr) const
+{
+    if(mem_addr < MMIO_START) {
+        return nullptr;
+    }
+
+    return mmio[mem_addr - MMIO_START];
 }
 
-InterruptType MachineState::peekInterrupt(void) const
+std::vector<std::pair<uint16_t, uint16_t>> MachineState::getAndClearDirtyRanges(void)
+{
+    // Device registers change without being written to, so compare them against their values at the previous call.
+    for(uint32_t i = 0; i < mmio.size(); i += 1) {
+        if(mmio[i] == nullptr) {
+            continue;
+        }
+
+        uint16_t addr = static_cast<uint16_t>(MMIO_START + i);
+        uint16_t value = mmio[i]->peek(addr);
+        if(mmio_snapshot[i] != value) {
+            mmio_snapshot[i] = value;
+            markDirty(addr);
+        }
+    }
+
+    std::vector<std::pair<uint16_t, uint16_t>> ranges;
+    for(uint32_t i = 0; i < dirty_pages.size(); i += 1) {
+        if(dirty_pages[i] == 0) {
+            continue;
+        }
+
+        for(uint32_t bit = 0; bit < 64; bit += 1) {
+            if(((dirty_pages[i] >> bit) & 1) == 0) {
+                continue;
+            }
+
+            uint32_t start = (i * 64 + bit) * DIRTY_PAGE_SIZE;
+            uint32_t end = start + DIRTY_PAGE_SIZE - 1;
+            if(ranges.size() > 0 && static_cast<uint32_t>(ranges.back().second) + 1 == start) {
+                ranges.back().second = static_cast<uint16_t>(end);
+            } else {
+                ranges.emplace_back(static_cast<uint16_t>(start), static_cast<uint16_t>(end));
+            }
+        }
+        dirty_pages[i] = 0;
+    }
+
+    return ranges;
+}
+
+Interrupt MachineState::peekInterrupt(void) const
 {
     if(pending_interrupts.size() == 0) {
-        return InterruptType::INVALID;
+        return Interrupt();
     }
 
     return pending_interrupts.front();
 }
 
-InterruptType MachineState::dequeueInterrupt(void)
+Interrupt MachineState::dequeueInterrupt(void)
 {
     if(pending_interrupts.size() == 0) {
-        return InterruptType::INVALID;
+        return Interrupt();
     }
 
-    InterruptType type = pending_interrupts.front();
+    Interrupt interrupt = pending_interrupts.front();
     pending_interrupts.pop();
-    return type;
+    return interrupt;
 }
 
 FuncType MachineState::peekFuncTraceType(void) const
@@ -106,7 +192,7 @@ FuncType MachineState::peekFuncTraceType(void) const
         return FuncType::INVALID;
     }
 
-    return func_trace.top();
+    return func_trace.back();
 }
 
 FuncType MachineState::popFuncTraceType(void)
@@ -115,7 +201,7 @@ FuncType MachineState::popFuncTraceType(void)
         return FuncType::INVALID;
     }
 
-    FuncType type = func_trace.top();
-    func_trace.pop();
+    FuncType type = func_trace.back();
+    func_trace.pop_back();
     return type;
 }
@@ -5,17 +5,17 @@
 #define STATE_H
 
 #include <queue>
-#include <stack>
 #include <string>
 #include <vector>
-#include <unordered_map>
 #include <utility>
 
 #include "aliases.h"
 #include "callback.h"
 #include "device.h"
+#include "framebuffer.h"
 #include "func_type.h"
 #include "intex.h"
+#include "loop_detector.h"
 #include "mem.h"
 
 namespace lc3
@@ -25,6 +25,13 @@ namespace core
     class IEvent;
     using PIEvent = std::shared_ptr<IEvent>;
 
+    struct MemWrite
+    {
+        uint16_t addr;
+        uint16_t old_value;
+        uint16_t value;
+    };
+
     class MachineState
     {
     public:
@@ -48,54 +55,89 @@ namespace core
         uint16_t readSSP(void) const { return ssp; }
         void writeSSP(uint16_t value) { ssp = value; }
 
-        uint16_t readPSR(void) const { return std::get<0>(readMem(PSR)); }
+        uint16_t readPSR(void) const { return peekMem(PSR); }
         void writePSR(uint16_t value) { writeMem(PSR, value); }
 
-        uint16_t readMCR(void) const { return std::get<0>(readMem(MCR)); }
+        uint16_t readMCR(void) const { return peekMem(MCR); }
         void writeMCR(uint16_t value) { writeMem(MCR, value); }
 
         uint16_t readReg(uint16_t id) const { return rf[id]; }
         void writeReg(uint16_t id, uint16_t value) { rf[id] = value; }
 
         std::pair<uint16_t, PIMicroOp> readMem(uint16_t addr) const;
+        // Read memory without triggering any device side effects (e.g. for display purposes).
+        uint16_t peekMem(uint16_t addr) const;
         PIMicroOp writeMem(uint16_t addr, uint16_t value);
         std::string getMemLine(uint16_t addr) const;
         void setMemLine(uint16_t addr, std::string const & value);
 
         void registerDeviceReg(uint16_t mem_addr, PIDevice device);
+        // The device mapped to a device register, or nullptr if there is none.
+        PIDevice getDeviceReg(uint16_t mem_addr) const;
+
+        // While set, every write to memory and device registers is appended to log.
+        void setMemWriteLog(std::vector<MemWrite> * log) { mem_write_log = log; }
+        // While set, writes to video memory are tracked by framebuffer.
+        void setFramebuffer(Framebuffer * framebuffer) { this->framebuffer = framebuffer; }
+        // While set, writes to memory are tracked by loop_detector.
+        void setLoopDetector(LoopDetector * loop_detector) { this->loop_detector = loop_detector; }
+
+        // Memory that was modified since the previous call, as inclusive address ranges. Modifications are tracked in
+        // pages of DIRTY_PAGE_SIZE words, so the ranges may also cover some unmodified memory.
+        std::vector<std::pair<uint16_t, uint16_t>> getAndClearDirtyRanges(void);
 
-        void enqueueInterrupt(InterruptType type) { pending_interrupts.push(type); }
-        InterruptType peekInterrupt(void) const;
-        InterruptType dequeueInterrupt(void);
+        void enqueueInterrupt(Interrupt const & interrupt) { pending_interrupts.push(interrupt); }
+        Interrupt peekInterrupt(void) const;
+        Interrupt dequeueInterrupt(void);
+        bool hasPendingInterrupt(void) const { return ! pending_interrupts.empty(); }
 
 
         bool isFirstInit(void) const { return first_init; }
         void completeFirstInit(void) { first_init = false; }
 
-        void pushFuncTraceType(FuncType type) { func_trace.push(type); }
+        void pushFuncTraceType(FuncType type) { func_trace.push_back(type); }
         FuncType peekFuncTraceType(void) const;
         FuncType popFuncTraceType(void);
+        std::vector<FuncType> const & getFuncTrace(void) const { return func_trace; }
+        void setFuncTrace(std::vector<FuncType> const & value) { func_trace = value; }
 
         std::vector<CallbackType> const & getPendingCallbacks(void) const { return pending_callbacks; }
         void clearPendingCallbacks(void) { pending_callbacks.clear(); }
         void addPendingCallback(CallbackType type) { pending_callbacks.push_back(type); }
 
+        static constexpr uint32_t DIRTY_PAGE_SIZE = 64;
+
     private:
         // Hardware state.
         std::vector<MemLocation> mem;
         std::vector<uint16_t> rf;
-        std::unordered_map<uint16_t, PIDevice> mmio;
+        // Indexed by address - MMIO_START, since device registers are read on every iteration of a polling loop.
+        std::vector<PIDevice> mmio;
         uint16_t reset_pc, pc, ir;
         PIInstruction decoded_ir;
         uint16_t ssp;
-        std::queue<InterruptType> pending_interrupts;
+        std::queue<Interrupt> pending_interrupts;
 
         // Simulation state.
         bool ignore_privilege;
         bool first_init;
 
-        std::stack<FuncType> func_trace;
+        std::vector<FuncType> func_trace;
         std::vector<CallbackType> pending_callbacks;
+
+        // One bit per page of memory.
+        std::vector<uint64_t> dirty_pages;
+        std::vector<uint16_t> mmio_snapshot;
+
+        std::vector<MemWrite> * mem_write_log;
+        Framebuffer * framebuffer;
+        LoopDetector * loop_detector;
+
+        void markDirty(uint16_t addr)
+        {
+            uint32_t page = addr / DIRTY_PAGE_SIZE;
+            dirty_pages[page / 64] |= 1ull << (page % 64);
+        }
     };
 };
 };
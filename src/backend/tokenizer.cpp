@@ -10,7 +10,7 @@ lc3::core::asmbl::Tokenizer::Tokenizer(std::istream & buffer, bool enable_libera
       enable_liberal_asm(enable_liberal_asm)
 { }
 
-std::istream & lc3::core::asmbl::Tokenizer::getline(std::istream & is, std::string & t) const
+std::istream & lc3::core::asmbl::Tokenizer::getline(std::istream & is, std::string & t)
 {
     t.clear();
 
@@ -130,6 +130,7 @@ lc3::core::asmbl::Tokenizer & lc3::core::asmbl::Tokenizer::operator>>(Token & to
         token.str = line.substr(col, len);
     }
 
+    token.quoted = found_string;
     token.col = col;
     token.row = row;
     token.len = len;
@@ -27,6 +27,8 @@ namespace asmbl
         bool operator!() const;
         explicit operator bool() const;
 
+        static std::istream & getline(std::istream & is, std::string & t);
+
     private:
         std::istream & buffer;
         bool get_new_line;
@@ -37,7 +39,6 @@ namespace asmbl
 
         bool convertStringToNum(std::string const & str, int32_t & val) const;
         bool isValidNumString(std::string const & str, uint32_t base) const;
-        std::istream & getline(std::istream & is, std::string & t) const;
 
         bool enable_liberal_asm;
     };
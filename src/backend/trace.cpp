@@ -0,0 +1,293 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#include <cstring>
+
+#include "device_regs.h"
+#include "state.h"
+#include "trace.h"
+
+static uint16_t zigzag(uint16_t value, uint16_t base)
+{
+    int16_t delta = static_cast<int16_t>(value - base);
+    return static_cast<uint16_t>((static_cast<uint16_t>(delta) << 1) ^ static_cast<uint16_t>(delta >> 15));
+}
+
+static uint16_t unzigzag(uint16_t value, uint16_t base)
+{
+    return static_cast<uint16_t>(base + ((value >> 1) ^ static_cast<uint16_t>(-(value & 1))));
+}
+
+lc3::core::TraceWriter::TraceWriter(std::string const & filename) :
+    file(filename, std::ios_base::binary), busy(false), done(false)
+{
+    file_good = static_cast<bool>(file);
+    buffer.reserve(TRACE_BUFFER_SIZE + 64);
+    thread = std::thread(&TraceWriter::run, this);
+}
+
+lc3::core::TraceWriter::~TraceWriter(void)
+{
+    flush();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        done = true;
+    }
+    cv.notify_all();
+    thread.join();
+}
+
+void lc3::core::TraceWriter::flush(void)
+{
+    if(! buffer.empty()) {
+        submit();
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [this]() { return pending.empty() && ! busy; });
+    file.flush();
+}
+
+void lc3::core::TraceWriter::submit(void)
+{
+    std::vector<char> full;
+    full.reserve(TRACE_BUFFER_SIZE + 64);
+    full.swap(buffer);
+    {
+        // Only block if the writer has fallen far behind, to bound the memory held by pending buffers.
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [this]() { return pending.size() < TRACE_MAX_PENDING_BUFFERS; });
+        pending.push_back(std::move(full));
+    }
+    cv.notify_all();
+}
+
+void lc3::core::TraceWriter::run(void)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while(true) {
+        cv.wait(lock, [this]() { return ! pending.empty() || done; });
+        if(pending.empty()) {
+            return;
+        }
+
+        std::vector<char> next = std::move(pending.front());
+        pending.pop_front();
+        busy = true;
+        lock.unlock();
+        cv.notify_all();
+
+        file.write(next.data(), next.size());
+
+        lock.lock();
+        busy = false;
+        cv.notify_all();
+    }
+}
+
+lc3::core::TraceRecorder::TraceRecorder(std::string const & filename) :
+    writer(filename), irs(1 << 16, 0), inst_count(0)
+{
+    for(char const * c = TRACE_MAGIC; *c != '\0'; ++c) {
+        writer.putByte(static_cast<uint8_t>(*c));
+    }
+}
+
+void lc3::core::TraceRecorder::sync(lc3::core::MachineState const & state)
+{
+    std::fill(irs.begin(), irs.end(), 0);
+    next_pc = state.readPC();
+    psr = state.readPSR();
+    mem_addr = 0;
+
+    writer.putByte(TRACE_SYNC);
+    writer.putNumber(inst_count);
+    writer.putNumber(next_pc);
+    writer.putNumber(psr);
+    for(uint16_t i = 0; i < 8; i += 1) {
+        regs[i] = state.readReg(i);
+        writer.putNumber(regs[i]);
+    }
+    writer.endRecord();
+}
+
+void lc3::core::TraceRecorder::recordInstruction(lc3::core::MachineState const & state, uint16_t pc, uint16_t ir,
+    std::vector<lc3::core::MemWrite> const & mem_writes)
+{
+    uint8_t flags = 0;
+    if(pc != next_pc) { flags |= TRACE_JUMP; }
+    if(ir != irs[pc]) { flags |= TRACE_IR; }
+
+    uint8_t reg_mask = 0;
+    for(uint16_t i = 0; i < 8; i += 1) {
+        if(state.readReg(i) != regs[i]) { reg_mask |= 1 << i; }
+    }
+    if(reg_mask != 0) { flags |= TRACE_REGS; }
+
+    uint16_t new_psr = state.readPSR();
+    if(new_psr != psr) { flags |= TRACE_PSR; }
+
+    // Changes to the PSR are already recorded on their own.
+    uint32_t num_mem_writes = 0;
+    for(auto const & write : mem_writes) {
+        if(write.addr != PSR) { num_mem_writes += 1; }
+    }
+    if(num_mem_writes != 0) { flags |= TRACE_MEM; }
+
+    writer.putByte(flags);
+    if(flags & TRACE_JUMP) {
+        writer.putNumber(zigzag(pc, next_pc));
+    }
+    if(flags & TRACE_IR) {
+        writer.putNumber(ir);
+        irs[pc] = ir;
+    }
+    if(flags & TRACE_REGS) {
+        writer.putByte(reg_mask);
+        for(uint16_t i = 0; i < 8; i += 1) {
+            if(reg_mask & (1 << i)) {
+                uint16_t value = state.readReg(i);
+                writer.putNumber(zigzag(value, regs[i]));
+                regs[i] = value;
+            }
+        }
+    }
+    if(flags & TRACE_PSR) {
+        writer.putNumber(zigzag(new_psr, psr));
+        psr = new_psr;
+    }
+    if(flags & TRACE_MEM) {
+        writer.putNumber(num_mem_writes);
+        for(auto const & write : mem_writes) {
+            if(write.addr != PSR) {
+                writer.putNumber(zigzag(write.addr, mem_addr));
+                writer.putNumber(write.value);
+                mem_addr = write.addr;
+            }
+        }
+    }
+    writer.endRecord();
+
+    next_pc = static_cast<uint16_t>(pc + 1);
+    inst_count += 1;
+}
+
+lc3::core::TraceReader::TraceReader(std::istream & in) : in(in), irs(1 << 16, 0), inst_count(0)
+{
+    size_t len = std::strlen(TRACE_MAGIC);
+    std::string magic(len, '\0');
+    valid = static_cast<bool>(in.read(&magic[0], len)) && magic == TRACE_MAGIC;
+}
+
+bool lc3::core::TraceReader::read(lc3::core::TraceRecord & record)
+{
+    if(! valid) {
+        return false;
+    }
+
+    char flags_byte;
+    if(! in.get(flags_byte)) {
+        return false;
+    }
+    uint8_t flags = static_cast<uint8_t>(flags_byte);
+
+    record.reg_writes.clear();
+    record.mem_writes.clear();
+    record.psr_changed = false;
+
+    if(flags & TRACE_SYNC) {
+        record.sync = true;
+        if(! getNumber(inst_count) || ! getValue(next_pc) || ! getValue(psr)) {
+            valid = false;
+            return false;
+        }
+        for(uint16_t i = 0; i < 8; i += 1) {
+            if(! getValue(regs[i])) {
+                valid = false;
+                return false;
+            }
+            record.reg_writes.emplace_back(i, regs[i]);
+        }
+        std::fill(irs.begin(), irs.end(), 0);
+        mem_addr = 0;
+
+        record.inst_count = inst_count;
+        record.pc = next_pc;
+        record.ir = 0;
+        record.psr_changed = true;
+        record.psr = psr;
+        return true;
+    }
+
+    record.sync = false;
+    record.inst_count = inst_count;
+    record.pc = next_pc;
+
+    uint16_t value;
+    if(flags & TRACE_JUMP) {
+        if(! getValue(value)) { valid = false; return false; }
+        record.pc = unzigzag(value, next_pc);
+    }
+    if(flags & TRACE_IR) {
+        if(! getValue(value)) { valid = false; return false; }
+        irs[record.pc] = value;
+    }
+    record.ir = irs[record.pc];
+    if(flags & TRACE_REGS) {
+        char reg_mask;
+        if(! in.get(reg_mask)) { valid = false; return false; }
+        for(uint16_t i = 0; i < 8; i += 1) {
+            if(static_cast<uint8_t>(reg_mask) & (1 << i)) {
+                if(! getValue(value)) { valid = false; return false; }
+                regs[i] = unzigzag(value, regs[i]);
+                record.reg_writes.emplace_back(i, regs[i]);
+            }
+        }
+    }
+    if(flags & TRACE_PSR) {
+        if(! getValue(value)) { valid = false; return false; }
+        psr = unzigzag(value, psr);
+        record.psr_changed = true;
+    }
+    record.psr = psr;
+    if(flags & TRACE_MEM) {
+        uint64_t num_mem_writes;
+        if(! getNumber(num_mem_writes)) { valid = false; return false; }
+        for(uint64_t i = 0; i < num_mem_writes; i += 1) {
+            if(! getValue(value)) { valid = false; return false; }
+            mem_addr = unzigzag(value, mem_addr);
+            if(! getValue(value)) { valid = false; return false; }
+            record.mem_writes.emplace_back(mem_addr, value);
+        }
+    }
+
+    next_pc = static_cast<uint16_t>(record.pc + 1);
+    inst_count += 1;
+    return true;
+}
+
+bool lc3::core::TraceReader::getNumber(uint64_t & value)
+{
+    value = 0;
+    for(uint32_t shift = 0; shift < 64; shift += 7) {
+        char byte;
+        if(! in.get(byte)) {
+            return false;
+        }
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool lc3::core::TraceReader::getValue(uint16_t & value)
+{
+    uint64_t number;
+    if(! getNumber(number) || number > 0xffff) {
+        return false;
+    }
+    value = static_cast<uint16_t>(number);
+    return true;
+}
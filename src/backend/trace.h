@@ -0,0 +1,155 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifndef TRACE_BUFFER_SIZE
+    #define TRACE_BUFFER_SIZE (64 * 1024)
+#endif
+
+#ifndef TRACE_MAX_PENDING_BUFFERS
+    #define TRACE_MAX_PENDING_BUFFERS 64
+#endif
+
+namespace lc3
+{
+namespace core
+{
+    class MachineState;
+    struct MemWrite;
+
+    // A trace file starts with TRACE_MAGIC, followed by one record per executed instruction. Each record starts with
+    // a byte of TRACE_* flags that indicate which of the following fields are present, in this order:
+    //   TRACE_SYNC:     the number of instructions traced so far, followed by the PC, PSR, and R0-R7 at the start of a
+    //                   run. A sync record does not correspond to an instruction, and it resets all of the deltas below.
+    //   TRACE_JUMP:     the PC as a delta from the address that follows the previous instruction.
+    //   TRACE_IR:       the instruction, which is omitted if it matches the last instruction at the same PC.
+    //   TRACE_REGS:     a mask of the modified registers, followed by the delta of each.
+    //   TRACE_PSR:      the delta of the PSR.
+    //   TRACE_MEM:      the number of memory writes, followed by the address (as a delta from the previous write)
+    //                   and the value of each.
+    // Signed deltas are zigzag encoded, and all numbers are variable length encoded with 7 bits per byte.
+    static constexpr char const * TRACE_MAGIC = "LC3TRACE1";
+    static constexpr uint8_t TRACE_SYNC = 0x80;
+    static constexpr uint8_t TRACE_JUMP = 0x01;
+    static constexpr uint8_t TRACE_IR = 0x02;
+    static constexpr uint8_t TRACE_REGS = 0x04;
+    static constexpr uint8_t TRACE_PSR = 0x08;
+    static constexpr uint8_t TRACE_MEM = 0x10;
+
+    // Writes buffers to a file on a background thread, so that the simulator never waits on the file system unless
+    // the writer falls far behind.
+    class TraceWriter
+    {
+    public:
+        TraceWriter(std::string const & filename);
+        ~TraceWriter(void);
+        TraceWriter(TraceWriter const &) = delete;
+        TraceWriter & operator=(TraceWriter const &) = delete;
+
+        bool good(void) const { return file_good; }
+
+        void putByte(uint8_t value)
+        {
+            buffer.push_back(static_cast<char>(value));
+        }
+        void putNumber(uint64_t value)
+        {
+            while(value >= 0x80) {
+                buffer.push_back(static_cast<char>((value & 0x7f) | 0x80));
+                value >>= 7;
+            }
+            buffer.push_back(static_cast<char>(value));
+        }
+        // Hand the buffer to the background thread once it is full.
+        void endRecord(void)
+        {
+            if(buffer.size() >= TRACE_BUFFER_SIZE) { submit(); }
+        }
+        void flush(void);
+
+    private:
+        std::ofstream file;
+        bool file_good;
+        std::vector<char> buffer;
+
+        std::thread thread;
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::deque<std::vector<char>> pending;
+        bool busy, done;
+
+        void submit(void);
+        void run(void);
+    };
+
+    // Encodes the effects of each executed instruction into a compact record stream.
+    class TraceRecorder
+    {
+    public:
+        TraceRecorder(std::string const & filename);
+
+        bool good(void) const { return writer.good(); }
+
+        // Record a snapshot of the state at the start of a run, against which the following records are encoded.
+        void sync(MachineState const & state);
+        void recordInstruction(MachineState const & state, uint16_t pc, uint16_t ir,
+            std::vector<MemWrite> const & mem_writes);
+        void flush(void) { writer.flush(); }
+
+    private:
+        TraceWriter writer;
+        std::vector<uint16_t> irs;
+        uint16_t regs[8];
+        uint16_t next_pc, psr, mem_addr;
+        uint64_t inst_count;
+    };
+
+    struct TraceRecord
+    {
+        bool sync;
+        uint64_t inst_count;
+        uint16_t pc;
+        uint16_t ir;
+        // Only the registers modified by the instruction, or all of the registers for a sync record.
+        std::vector<std::pair<uint16_t, uint16_t>> reg_writes;
+        bool psr_changed;
+        uint16_t psr;
+        std::vector<std::pair<uint16_t, uint16_t>> mem_writes;
+    };
+
+    class TraceReader
+    {
+    public:
+        TraceReader(std::istream & in);
+
+        // Returns false once the trace ends, or if it is not a valid trace.
+        bool read(TraceRecord & record);
+        bool isValid(void) const { return valid; }
+
+    private:
+        std::istream & in;
+        bool valid;
+        std::vector<uint16_t> irs;
+        uint16_t regs[8];
+        uint16_t next_pc, psr, mem_addr;
+        uint64_t inst_count;
+
+        bool getNumber(uint64_t & value);
+        bool getValue(uint16_t & value);
+    };
+};
+};
+
+#endif
@@ -438,14 +438,14 @@ std::string CallbackMicroOp::toString(MachineState const & state) const
 
 void PushInterruptTypeMicroOp::handleMicroOp(MachineState & state)
 {
-    state.enqueueInterrupt(type);
+    state.enqueueInterrupt(interrupt);
 }
 
 std::string PushInterruptTypeMicroOp::toString(MachineState const & state) const
 {
     (void) state;
 
-    return lc3::utils::ssprintf("interrupts <= %s", interruptTypeToString(type).c_str());
+    return lc3::utils::ssprintf("interrupts <= %s", interruptTypeToString(interrupt.type).c_str());
 }
 
 void PopInterruptTypeMicroOp::handleMicroOp(MachineState & state)
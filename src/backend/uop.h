@@ -319,13 +319,13 @@ namespace core
     class PushInterruptTypeMicroOp : public IMicroOp
     {
     public:
-        PushInterruptTypeMicroOp(InterruptType type) : IMicroOp(), type(type) { }
+        PushInterruptTypeMicroOp(Interrupt const & interrupt) : IMicroOp(), interrupt(interrupt) { }
 
         virtual void handleMicroOp(MachineState & state) override;
         virtual std::string toString(MachineState const & state) const override;
 
     private:
-        InterruptType type;
+        Interrupt interrupt;
     };
 
     class PopInterruptTypeMicroOp : public IMicroOp
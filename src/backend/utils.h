@@ -106,6 +106,8 @@ namespace lc3
     {
         std::string getMagicHeader(void);
         std::string getVersionString(void);
+        // Must change whenever the assembler's output for a given input changes, since cached objects are keyed on it.
+        std::string getAssemblerVersion(void);
 
         std::string udecToBin(uint32_t value, uint32_t num_bits);
         uint32_t sextTo32(uint32_t value, uint32_t num_bits);
@@ -1,6 +1,7 @@
 /*
  * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
  */
+#include <fstream>
 #include <string>
 
 #define API_VER 2
@@ -12,6 +13,9 @@ struct CLIArgs
 {
     uint32_t print_level = DEFAULT_PRINT_LEVEL;
     bool enable_liberal_asm = false;
+    std::string diagnostics_filename = "";
+    std::string cache_dir = "";
+    uint64_t cache_size = DEFAULT_ASM_CACHE_SIZE;
 };
 
 bool endsWith(std::string const & search, std::string const & suffix)
@@ -29,12 +33,21 @@ int main(int argc, char *argv[])
             args.print_level = std::stoi(std::get<1>(arg));
         } else if(std::get<0>(arg) == "enable-liberal-asm") {
             args.enable_liberal_asm = true;
+        } else if(std::get<0>(arg) == "diagnostics") {
+            args.diagnostics_filename = std::get<1>(arg);
+        } else if(std::get<0>(arg) == "cache-dir") {
+            args.cache_dir = std::get<1>(arg);
+        } else if(std::get<0>(arg) == "cache-size") {
+            args.cache_size = std::stoull(std::get<1>(arg)) * 1024 * 1024;
         } else if(std::get<0>(arg) == "h" || std::get<0>(arg) == "help") {
             std::cout << "usage: " << argv[0] << " [OPTIONS] FILE [FILE...]\n";
             std::cout << "\n";
             std::cout << "  -h,--help              Print this message\n";
             std::cout << "  --print-level=N        Output verbosity [0-9]\n";
             std::cout << "  --enable-liberal-asm   Enable liberal assembly mode\n";
+            std::cout << "  --diagnostics=file     Write warnings and errors to file as JSON\n";
+            std::cout << "  --cache-dir=DIR        Reuse objects of previously assembled sources cached in DIR\n";
+            std::cout << "  --cache-size=N         Maximum cache size in MB [default 64]\n";
             return 0;
         }
     }
@@ -42,6 +55,12 @@ int main(int argc, char *argv[])
     lc3::ConsolePrinter printer;
     lc3::as assembler(printer, args.print_level, args.enable_liberal_asm);
     lc3::conv converter(printer, args.print_level);
+    assembler.setCacheDirectory(args.cache_dir, args.cache_size);
+
+    std::ofstream diagnostics_file;
+    if(args.diagnostics_filename != "") {
+        diagnostics_file.open(args.diagnostics_filename);
+    }
 
     for(int i = 1; i < argc; i += 1) {
         std::string filename(argv[i]);
@@ -50,6 +69,11 @@ int main(int argc, char *argv[])
                 converter.convertBin(filename);
             } else {
                 assembler.assemble(filename);
+                if(diagnostics_file.is_open()) {
+                    for(lc3::utils::AssemblerDiagnostic const & diagnostic : assembler.getDiagnostics()) {
+                        diagnostics_file << diagnostic.toJSON() << "\n";
+                    }
+                }
             }
         }
     }
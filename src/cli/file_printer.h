@@ -6,22 +6,44 @@
 
 #include <iostream>
 #include <fstream>
+#include <string>
 
 #include "printer.h"
 
 namespace lc3
 {
+    // Buffers output in the same way as ConsolePrinter, so the log is complete up to the last line whenever the
+    // program waits for input or stops.
     class FilePrinter : public utils::IPrinter
     {
     public:
-        FilePrinter(std::string const & filename) : output(filename) { }
+        FilePrinter(std::string const & filename, std::size_t buffer_size = DEFAULT_PRINT_BUFFER_SIZE) :
+            output(filename), buffer_size(buffer_size) { }
+        virtual ~FilePrinter(void) { flush(); }
 
         virtual void setColor(utils::PrintColor color) override { (void) color; return; }
-        virtual void print(std::string const & string) override { output << string << std::flush; }
-        virtual void newline(void) override { output << "\n"; }
+        virtual void print(std::string const & string) override
+        {
+            buffer += string;
+            if(buffer.size() >= buffer_size) { flush(); }
+        }
+        virtual void newline(void) override
+        {
+            buffer += '\n';
+            flush();
+        }
+        virtual void flush(void) override
+        {
+            if(! buffer.empty()) {
+                output << buffer << std::flush;
+                buffer.clear();
+            }
+        }
 
     private:
         std::ofstream output;
+        std::size_t buffer_size;
+        std::string buffer;
     };
 };
 
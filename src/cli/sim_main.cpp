@@ -5,6 +5,7 @@
 #ifdef _ENABLE_DEBUG
     #include <chrono>
 #endif
+#include <fstream>
 #include <iostream>
 #include <vector>
 #include <sstream>
@@ -16,6 +17,7 @@
 #include "console_inputter.h"
 #include "file_printer.h"
 #include "interface.h"
+#include "recording_inputter.h"
 
 std::string previous_command = "";
 
@@ -45,6 +47,16 @@ struct CLIArgs
     uint32_t print_level = DEFAULT_PRINT_LEVEL;
     std::string log_file = "";
     bool ignore_privilege = false;
+    bool profile = false;
+    std::string trace_file = "";
+    std::string record_input_file = "";
+    std::string replay_input_file = "";
+    bool reverse = false;
+    uint64_t reverse_size = DEFAULT_HISTORY_SIZE;
+    std::string framebuffer_prefix = "";
+    bool native_traps = false;
+    uint64_t native_trap_charge = 1;
+    bool skip_polling = false;
 };
 
 int main(int argc, char * argv[])
@@ -58,6 +70,28 @@ int main(int argc, char * argv[])
             args.ignore_privilege = true;
         } else if(std::get<0>(arg) == "log") {
             args.log_file = std::get<1>(arg);
+        } else if(std::get<0>(arg) == "profile") {
+            args.profile = true;
+        } else if(std::get<0>(arg) == "trace") {
+            args.trace_file = std::get<1>(arg);
+        } else if(std::get<0>(arg) == "record-input") {
+            args.record_input_file = std::get<1>(arg);
+        } else if(std::get<0>(arg) == "replay-input") {
+            args.replay_input_file = std::get<1>(arg);
+        } else if(std::get<0>(arg) == "reverse") {
+            args.reverse = true;
+            if(std::get<1>(arg) != "") {
+                args.reverse_size = std::stoull(std::get<1>(arg)) * 1024 * 1024;
+            }
+        } else if(std::get<0>(arg) == "native-traps") {
+            args.native_traps = true;
+            if(std::get<1>(arg) != "") {
+                args.native_trap_charge = std::stoull(std::get<1>(arg));
+            }
+        } else if(std::get<0>(arg) == "skip-polling") {
+            args.skip_polling = true;
+        } else if(std::get<0>(arg) == "framebuffer") {
+            args.framebuffer_prefix = std::get<1>(arg);
         } else if(std::get<0>(arg) == "h" || std::get<0>(arg) == "help") {
             std::cout << "usage: " << argv[0] << " [OPTIONS] FILE [FILE...]\n";
             std::cout << "\n";
@@ -65,6 +99,17 @@ int main(int argc, char * argv[])
             std::cout << "  --print-level=N        Output verbosity [0-9]\n";
             std::cout << "  --ignore-privilege     Ignore access violations\n";
             std::cout << "  --log=file             Output to log file\n";
+            std::cout << "  --profile              Count the instructions executed at each address and subroutine\n";
+            std::cout << "  --trace=file           Write a binary execution trace to file\n";
+            std::cout << "  --record-input=file    Record keyboard input, and when it arrived, to file\n";
+            std::cout << "  --replay-input=file    Replay keyboard input recorded with --record-input\n";
+            std::cout << "  --reverse[=N]          Remember up to N MB of executed instructions so that they can be\n";
+            std::cout << "                         undone [default 64]\n";
+            std::cout << "  --native-traps[=N]     Perform OS traps directly, counting each as N instructions\n";
+            std::cout << "                         [default 1]\n";
+            std::cout << "  --skip-polling         Fast-forward loops that wait on KBSR, DSR, or TMCR when replaying\n";
+            std::cout << "                         input\n";
+            std::cout << "  --framebuffer=prefix   Write video memory to prefixNNNN.ppm whenever a command modifies it\n";
             return 0;
         }
     }
@@ -77,13 +122,51 @@ int main(int argc, char * argv[])
     } else {
         printer = std::make_shared<lc3::ConsolePrinter>();
     }
-    lc3::ConsoleInputter inputter;
-    lc3::sim simulator(*printer, inputter, args.print_level);
+    lc3::ConsoleInputter console_inputter;
+    std::shared_ptr<lc3::RecordingInputter> recorder;
+    std::shared_ptr<lc3::ReplayInputter> replayer;
+    lc3::utils::IInputter * inputter = &console_inputter;
+    if(args.replay_input_file != "") {
+        replayer = std::make_shared<lc3::ReplayInputter>(args.replay_input_file);
+        if(! replayer->good()) {
+            std::cout << "could not read " << args.replay_input_file << "\n";
+            return 1;
+        }
+        inputter = replayer.get();
+    } else if(args.record_input_file != "") {
+        recorder = std::make_shared<lc3::RecordingInputter>(console_inputter, args.record_input_file);
+        if(! recorder->good()) {
+            std::cout << "could not open " << args.record_input_file << " for writing\n";
+            return 1;
+        }
+        inputter = recorder.get();
+    }
+    lc3::sim simulator(*printer, *inputter, args.print_level);
+    if(replayer != nullptr) {
+        replayer->attach(simulator);
+    } else if(recorder != nullptr) {
+        recorder->attach(simulator);
+    }
 
     simulator.registerCallback(lc3::core::CallbackType::BREAKPOINT, breakpointCallback);
     if(args.ignore_privilege) {
         simulator.setIgnorePrivilege(true);
     }
+    if(args.profile) {
+        simulator.setEnableProfiler(true);
+    }
+    if(args.trace_file != "") {
+        simulator.startTrace(args.trace_file);
+    }
+    if(args.reverse) {
+        simulator.setEnableReverse(true, args.reverse_size);
+    }
+    if(args.native_traps) {
+        simulator.setEnableNativeTraps(true, args.native_trap_charge);
+    }
+    if(args.skip_polling) {
+        simulator.setEnablePollSkipping(true);
+    }
 
     for(int i = 1; i < argc; i += 1) {
         std::string arg(argv[i]);
@@ -92,7 +175,21 @@ int main(int argc, char * argv[])
         }
     }
 
-    while(prompt(simulator)) {}
+    if(args.framebuffer_prefix != "") {
+        simulator.setEnableFramebuffer(true);
+        simulator.getAndClearFramebufferDirtyRects();
+    }
+
+    uint32_t frame = 0;
+    while(prompt(simulator)) {
+        if(args.framebuffer_prefix != "" && ! simulator.getAndClearFramebufferDirtyRects().empty()) {
+            std::string filename = lc3::utils::ssprintf("%s%04u.ppm", args.framebuffer_prefix.c_str(), frame);
+            if(! simulator.writeFramebufferPPM(filename)) {
+                std::cout << "could not open " << filename << " for writing\n";
+            }
+            frame += 1;
+        }
+    }
 
     return 0;
 }
@@ -107,12 +204,17 @@ void help(void)
 #ifdef _ENABLE_DEBUG
               << "printlevel N             - sets the print level to N\n"
 #endif
+              << "profile <fmt> [<file>]   - display or write the profile (requires --profile) as json or folded\n"
+              << "                           stacks, or reset the profile if fmt is reset\n"
               << "quit                     - exit the simulator\n"
               << "randomize                - randomize the memory and general purpose registers\n"
+              << "rcontinue                - runs backwards to the previous breakpoint (requires --reverse)\n"
               << "regs                     - display register values\n"
               << "restart                  - restart program (and go to user mode)\n"
               << "run [<instructions>]     - runs to end of program or, if specified, the number of instructions\n"
               << "set <loc> <value>        - sets loc (either register name or memory address) to value\n"
+              << "step back [<N>]          - undoes the last instruction or, if specified, N instructions (requires\n"
+              << "                           --reverse)\n"
               << "step in                  - executes a single instruction\n"
               << "step over                - executes a single instruction (treats subroutine calls as a single\n"
               << "                           instruction)\n"
@@ -209,8 +311,45 @@ bool promptMain(lc3::sim & simulator, std::stringstream & command_tokens)
         }
         simulator.setPrintLevel(print_level);
 #endif
+    } else if(command == "profile") {
+        std::string format, filename;
+        command_tokens >> format;
+        if(command_tokens.fail()) {
+            std::cout << "must specify profile format\n";
+            return true;
+        }
+        command_tokens >> filename;
+
+        std::string profile;
+        if(format == "json") {
+            profile = simulator.getProfileJSON() + "\n";
+        } else if(format == "folded") {
+            profile = simulator.getProfileFoldedStacks();
+        } else if(format == "reset") {
+            simulator.resetProfiler();
+            return true;
+        } else {
+            std::cout << "invalid profile format\n";
+            return true;
+        }
+
+        if(filename == "") {
+            std::cout << profile;
+        } else {
+            std::ofstream out_file(filename);
+            if(! out_file) {
+                std::cout << "could not open " << filename << " for writing\n";
+                return true;
+            }
+            out_file << profile;
+        }
     } else if(command == "quit") {
         return false;
+    } else if(command == "rcontinue") {
+        if(! simulator.reverseContinue()) {
+            std::cout << "reached the beginning of the history\n";
+        }
+        list(simulator, 2);
     } else if(command == "randomize") {
         simulator.randomizeState();
     } else if(command == "restart") {
@@ -290,7 +429,17 @@ bool promptMain(lc3::sim & simulator, std::stringstream & command_tokens)
             return true;
         }
 
-        if(sub_command == "in") {
+        if(sub_command == "back") {
+            uint64_t count;
+            command_tokens >> count;
+            if(command_tokens.fail()) {
+                count = 1;
+            }
+            if(! simulator.stepBack(count)) {
+                std::cout << "reached the beginning of the history\n";
+            }
+            list(simulator, 2);
+        } else if(sub_command == "in") {
             simulator.stepIn();
             list(simulator, 2);
         } else if(sub_command == "out") {
@@ -0,0 +1,120 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "common.h"
+#include "decoder.h"
+#include "trace.h"
+#include "utils.h"
+
+struct CLIArgs
+{
+    uint32_t start = 0x0000;
+    uint32_t end = 0xffff;
+};
+
+uint32_t parseAddr(std::string const & str)
+{
+    // Accept LC-3 style hex (e.g. x3000) in addition to anything stoi accepts.
+    if(str.size() > 1 && (str[0] == 'x' || str[0] == 'X')) {
+        return std::stoi(str.substr(1), 0, 16);
+    }
+    return std::stoi(str, 0, 0);
+}
+
+std::string formatRecord(lc3::core::TraceRecord const & record, lc3::core::sim::Decoder const & decoder)
+{
+    std::string ret;
+    if(record.sync) {
+        ret = lc3::utils::ssprintf("--- run start at #%llu: PC=x%04X PSR=x%04X",
+            static_cast<unsigned long long>(record.inst_count), record.pc, record.psr);
+        for(auto const & reg : record.reg_writes) {
+            ret += lc3::utils::ssprintf(" R%u=x%04X", reg.first, reg.second);
+        }
+        return ret;
+    }
+
+    std::string assembly = "";
+    lc3::optional<lc3::core::PIInstruction> inst = decoder.decode(record.ir);
+    if(inst) {
+        assembly = (*inst)->toValueString();
+    }
+    ret = lc3::utils::ssprintf("#%llu x%04X x%04X %s", static_cast<unsigned long long>(record.inst_count),
+        record.pc, record.ir, assembly.c_str());
+
+    std::string changes;
+    for(auto const & reg : record.reg_writes) {
+        changes += lc3::utils::ssprintf(" R%u=x%04X", reg.first, reg.second);
+    }
+    if(record.psr_changed) {
+        changes += lc3::utils::ssprintf(" PSR=x%04X", record.psr);
+    }
+    for(auto const & write : record.mem_writes) {
+        changes += lc3::utils::ssprintf(" M[x%04X]=x%04X", write.first, write.second);
+    }
+    if(changes != "") {
+        ret += std::string(assembly.size() < 20 ? 20 - assembly.size() : 0, ' ') + " |" + changes;
+    }
+    return ret;
+}
+
+int main(int argc, char * argv[])
+{
+    CLIArgs args;
+    std::vector<std::pair<std::string, std::string>> parsed_args = parseCLIArgs(argc, argv);
+    for(auto const & arg : parsed_args) {
+        if(std::get<0>(arg) == "start") {
+            args.start = parseAddr(std::get<1>(arg));
+        } else if(std::get<0>(arg) == "end") {
+            args.end = parseAddr(std::get<1>(arg));
+        } else if(std::get<0>(arg) == "h" || std::get<0>(arg) == "help") {
+            std::cout << "usage: " << argv[0] << " [OPTIONS] FILE [FILE...]\n";
+            std::cout << "\n";
+            std::cout << "  -h,--help              Print this message\n";
+            std::cout << "  --start=ADDR           Only print instructions at or writing to ADDR or above\n";
+            std::cout << "  --end=ADDR             Only print instructions at or writing to ADDR or below\n";
+            return 0;
+        }
+    }
+
+    lc3::core::sim::Decoder decoder;
+
+    for(int i = 1; i < argc; i += 1) {
+        std::string filename(argv[i]);
+        if(filename[0] == '-') {
+            continue;
+        }
+
+        std::ifstream trace_file(filename, std::ios_base::binary);
+        if(! trace_file) {
+            std::cout << "could not open file " << filename << "\n";
+            continue;
+        }
+
+        lc3::core::TraceReader reader(trace_file);
+        if(! reader.isValid()) {
+            std::cout << filename << " is not a trace file\n";
+            continue;
+        }
+
+        lc3::core::TraceRecord record;
+        while(reader.read(record)) {
+            bool matches = record.sync || (args.start <= record.pc && record.pc <= args.end);
+            for(auto const & write : record.mem_writes) {
+                matches = matches || (args.start <= write.first && write.first <= args.end);
+            }
+            if(matches) {
+                std::cout << formatRecord(record, decoder) << "\n";
+            }
+        }
+
+        if(! reader.isValid()) {
+            std::cout << filename << " is truncated or damaged\n";
+        }
+    }
+
+    return 0;
+}
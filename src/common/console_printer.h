@@ -4,16 +4,28 @@
 #ifndef CONSOLE_PRINTER_H
 #define CONSOLE_PRINTER_H
 
+#include <string>
+
 #include "printer.h"
 
 namespace lc3
 {
+    // Output is written once a line is complete, once buffer_size characters are waiting, or when flushed, rather
+    // than a system call at a time for each character that a program prints.
     class ConsolePrinter : public utils::IPrinter
     {
     public:
+        ConsolePrinter(std::size_t buffer_size = DEFAULT_PRINT_BUFFER_SIZE) : buffer_size(buffer_size) {}
+        virtual ~ConsolePrinter(void) { flush(); }
+
         virtual void setColor(utils::PrintColor color) override;
         virtual void print(std::string const & string) override;
         virtual void newline(void) override;
+        virtual void flush(void) override;
+
+    private:
+        std::size_t buffer_size;
+        std::string buffer;
     };
 };
 
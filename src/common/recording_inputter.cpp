@@ -0,0 +1,70 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#include "recording_inputter.h"
+
+#include <limits>
+
+lc3::RecordingInputter::RecordingInputter(lc3::utils::IInputter & inputter, std::string const & filename) :
+    inputter(inputter), log(filename), simulator(nullptr)
+{}
+
+bool lc3::RecordingInputter::getChar(char & c)
+{
+    if(! inputter.getChar(c)) {
+        return false;
+    }
+
+    uint64_t inst_count = simulator != nullptr ? simulator->getInstExecCount() : 0;
+    log << inst_count << " " << static_cast<uint32_t>(static_cast<unsigned char>(c)) << "\n";
+    return true;
+}
+
+void lc3::RecordingInputter::endInput(void)
+{
+    // Keep the log complete whenever the simulator is not running, in case the program is killed.
+    log.flush();
+    inputter.endInput();
+}
+
+lc3::ReplayInputter::ReplayInputter(std::string const & filename) : pos(0), valid(true), simulator(nullptr)
+{
+    std::ifstream log(filename);
+    if(! log) {
+        valid = false;
+        return;
+    }
+
+    uint64_t inst_count;
+    uint32_t code;
+    while(log >> inst_count >> code) {
+        records.emplace_back(inst_count, static_cast<char>(code));
+    }
+    valid = log.eof();
+}
+
+bool lc3::ReplayInputter::getChar(char & c)
+{
+    // The keyboard asks for a character before every instruction, so at most one character is delivered per
+    // instruction, exactly as it was recorded.
+    uint64_t inst_count = simulator != nullptr ? simulator->getInstExecCount() : 0;
+    if(pos == records.size() || records[pos].first > inst_count) {
+        return false;
+    }
+
+    c = records[pos].second;
+    pos += 1;
+    return true;
+}
+
+uint64_t lc3::ReplayInputter::getIdleCount(void) const
+{
+    if(pos == records.size()) {
+        return std::numeric_limits<uint64_t>::max();
+    }
+
+    // The next call is made before the next instruction, so the calls before instructions numbered inst_count + 1
+    // through records[pos].first - 1 are the ones that fail.
+    uint64_t inst_count = simulator != nullptr ? simulator->getInstExecCount() : 0;
+    return records[pos].first > inst_count + 1 ? records[pos].first - inst_count - 1 : 0;
+}
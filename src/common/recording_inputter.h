@@ -0,0 +1,67 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#ifndef RECORDING_INPUTTER_H
+#define RECORDING_INPUTTER_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "inputter.h"
+#include "interface.h"
+
+namespace lc3
+{
+    // Forwards input from another inputter to the simulator and logs each character along with the number of
+    // instructions that had been executed when the keyboard received it. Each line of the log is formatted as
+    // "INST_COUNT CHAR_CODE".
+    class RecordingInputter : public utils::IInputter
+    {
+    public:
+        RecordingInputter(utils::IInputter & inputter, std::string const & filename);
+
+        bool good(void) const { return static_cast<bool>(log); }
+        // Must be called before the simulator runs, since the simulator is created after its inputter.
+        void attach(lc3::sim const & simulator) { this->simulator = &simulator; }
+
+        virtual void beginInput(void) override { inputter.beginInput(); }
+        virtual bool getChar(char & c) override;
+        virtual void endInput(void) override;
+        virtual bool hasRemaining(void) const override { return inputter.hasRemaining(); }
+        virtual uint64_t getIdleCount(void) const override { return inputter.getIdleCount(); }
+        virtual void skipIdle(uint64_t count) override { inputter.skipIdle(count); }
+
+    private:
+        utils::IInputter & inputter;
+        std::ofstream log;
+        lc3::sim const * simulator;
+    };
+
+    // Delivers the characters of a log written by RecordingInputter to the keyboard at the same instruction counts
+    // they were recorded at, regardless of how long the simulator takes to get there.
+    class ReplayInputter : public utils::IInputter
+    {
+    public:
+        ReplayInputter(std::string const & filename);
+
+        bool good(void) const { return valid; }
+        void attach(lc3::sim const & simulator) { this->simulator = &simulator; }
+
+        virtual void beginInput(void) override {}
+        virtual bool getChar(char & c) override;
+        virtual void endInput(void) override {}
+        virtual bool hasRemaining(void) const override { return pos < records.size(); }
+        virtual uint64_t getIdleCount(void) const override;
+
+    private:
+        std::vector<std::pair<uint64_t, char>> records;
+        std::size_t pos;
+        bool valid;
+        lc3::sim const * simulator;
+    };
+};
+
+#endif
@@ -9,9 +9,13 @@ namespace utils
     class UIPrinter : public lc3::utils::IPrinter
     {
     private:
-        std::mutex output_buffer_mutex;
+        mutable std::mutex output_buffer_mutex;
         std::vector<std::string> output_buffer;
         uint32_t pending_colors;
+        // Counts all of the output since the buffer was last cleared, since the UI keeps what it takes from it.
+        lc3::utils::OutputLimiter limiter;
+
+        void keep(std::string const & string);
 
     public:
         UIPrinter(void) : pending_colors(0) {}
@@ -19,6 +23,8 @@ namespace utils
         virtual void setColor(lc3::utils::PrintColor color) override;
         virtual void print(std::string const & string) override;
         virtual void newline(void) override;
+        virtual void setOutputLimit(uint64_t limit) override;
+        virtual bool didExceedOutputLimit(void) const override;
 
         std::vector<std::string> getAndClearOutputBuffer(void);
         void clearOutputBuffer(void);
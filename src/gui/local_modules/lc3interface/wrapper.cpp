@@ -10,6 +10,7 @@
 #include <algorithm>
 #include <memory>
 #include <mutex>
+#include <string>
 
 #define API_VER 2
 #include "interface.h"
@@ -62,8 +63,11 @@ NAN_METHOD(Init)
 {
     try {
         as = std::make_shared<lc3::as>(printer, DEFAULT_PRINT_LEVEL, false);
+        as->setEnableIncrementalAsm(true);
         conv = std::make_shared<lc3::conv>(printer, DEFAULT_PRINT_LEVEL);
         sim = std::make_shared<lc3::sim>(printer, inputter, DEFAULT_PRINT_LEVEL);
+        // The UI inputter doesn't need to know when the simulator stops, so stepping can skip restarting devices.
+        sim->beginSession();
         sim->registerCallback(lc3::core::CallbackType::BREAKPOINT,
             [](lc3::core::CallbackType, lc3::sim &) {
                 hit_breakpoint = true;
@@ -347,6 +351,32 @@ NAN_METHOD(GetRegValue)
     info.GetReturnValue().Set(ret);
 }
 
+NAN_METHOD(GetRegisters)
+{
+    try {
+        v8::Local<v8::Object> ret = Nan::New<v8::Object>();
+        for(uint32_t i = 0; i < 8; i += 1) {
+            Nan::Set(ret, Nan::New("r" + std::to_string(i)).ToLocalChecked(), Nan::New<v8::Number>(sim->readReg(i)));
+        }
+        uint16_t psr = sim->readPSR();
+        char const * cc = "Undefined";
+        switch(psr & 0x7) {
+            case 0x1: cc = "P"; break;
+            case 0x2: cc = "Z"; break;
+            case 0x4: cc = "N"; break;
+            default: break;
+        }
+        Nan::Set(ret, Nan::New("ir").ToLocalChecked(), Nan::New<v8::Number>(sim->readMem(sim->readPC())));
+        Nan::Set(ret, Nan::New("pc").ToLocalChecked(), Nan::New<v8::Number>(sim->readPC()));
+        Nan::Set(ret, Nan::New("psr").ToLocalChecked(), Nan::New<v8::Number>(psr));
+        Nan::Set(ret, Nan::New("mcr").ToLocalChecked(), Nan::New<v8::Number>(sim->readMCR()));
+        Nan::Set(ret, Nan::New("cc").ToLocalChecked(), Nan::New(cc).ToLocalChecked());
+        info.GetReturnValue().Set(ret);
+    } catch(std::exception const & e) {
+        Nan::ThrowError(e.what());
+    }
+}
+
 NAN_METHOD(SetRegValue)
 {
     if(info.Length() != 2) {
@@ -410,6 +440,32 @@ NAN_METHOD(GetMemValue)
     }
 }
 
+NAN_METHOD(GetMemRange)
+{
+    if(info.Length() != 2) {
+        Nan::ThrowError("Requires 2 arguments");
+        return;
+    }
+
+    if(! info[0]->IsNumber() || ! info[1]->IsNumber()) {
+        Nan::ThrowError("Must provide start address and count as numerical arguments");
+        return;
+    }
+
+    uint32_t start = Nan::To<uint32_t>(info[0]).FromJust();
+    uint32_t count = std::min(Nan::To<uint32_t>(info[1]).FromJust(), static_cast<uint32_t>(0x10000));
+    try {
+        // Read directly into the array's buffer rather than creating a value per address.
+        v8::Local<v8::ArrayBuffer> buffer = v8::ArrayBuffer::New(v8::Isolate::GetCurrent(), count * sizeof(uint16_t));
+        v8::Local<v8::Uint16Array> ret = v8::Uint16Array::New(buffer, 0, count);
+        Nan::TypedArrayContents<uint16_t> values(ret);
+        sim->readMemRange(static_cast<uint16_t>(start), count, *values);
+        info.GetReturnValue().Set(ret);
+    } catch(std::exception const & e) {
+        Nan::ThrowError(e.what());
+    }
+}
+
 NAN_METHOD(SetMemValue)
 {
     if(info.Length() != 2) {
@@ -459,6 +515,156 @@ NAN_METHOD(GetMemLine)
     }
 }
 
+NAN_METHOD(GetMemLines)
+{
+    if(info.Length() != 2) {
+        Nan::ThrowError("Requires 2 arguments");
+        return;
+    }
+
+    if(! info[0]->IsNumber() || ! info[1]->IsNumber()) {
+        Nan::ThrowError("Must provide start address and count as numerical arguments");
+        return;
+    }
+
+    uint32_t start = Nan::To<uint32_t>(info[0]).FromJust();
+    uint32_t count = std::min(Nan::To<uint32_t>(info[1]).FromJust(), static_cast<uint32_t>(0x10000));
+    try {
+        v8::Local<v8::Array> ret = Nan::New<v8::Array>(count);
+        for(uint32_t i = 0; i < count; i += 1) {
+            Nan::Set(ret, i, Nan::New<v8::String>(sim->getMemLine(static_cast<uint16_t>(start + i))).ToLocalChecked());
+        }
+        info.GetReturnValue().Set(ret);
+    } catch(std::exception const & e) {
+        Nan::ThrowError(e.what());
+    }
+}
+
+NAN_METHOD(GetAndClearModifiedRanges)
+{
+    try {
+        std::vector<std::pair<uint16_t, uint16_t>> ranges = sim->getAndClearModifiedRanges();
+        v8::Local<v8::Array> ret = Nan::New<v8::Array>(ranges.size());
+        for(uint32_t i = 0; i < ranges.size(); i += 1) {
+            v8::Local<v8::Object> range = Nan::New<v8::Object>();
+            Nan::Set(range, Nan::New("start").ToLocalChecked(), Nan::New<v8::Number>(ranges[i].first));
+            Nan::Set(range, Nan::New("end").ToLocalChecked(), Nan::New<v8::Number>(ranges[i].second));
+            Nan::Set(ret, i, range);
+        }
+        info.GetReturnValue().Set(ret);
+    } catch(std::exception const & e) {
+        Nan::ThrowError(e.what());
+    }
+}
+
+NAN_METHOD(SetProgressUpdates)
+{
+    if(info.Length() != 4) {
+        Nan::ThrowError("Requires 4 arguments");
+        return;
+    }
+
+    if(! info[0]->IsNumber() || ! info[1]->IsNumber()) {
+        Nan::ThrowError("Must provide instruction and time intervals as numerical arguments");
+        return;
+    }
+
+    if(! info[2]->IsBoolean() || ! info[3]->IsBoolean()) {
+        Nan::ThrowError("Must provide output and modified range settings as bool arguments");
+        return;
+    }
+
+    try {
+        sim->setProgressUpdates(static_cast<uint64_t>(Nan::To<double>(info[0]).FromJust()),
+            Nan::To<uint32_t>(info[1]).FromJust(), Nan::To<bool>(info[2]).FromJust(),
+            Nan::To<bool>(info[3]).FromJust());
+    } catch(std::exception const & e) {
+        Nan::ThrowError(e.what());
+    }
+}
+
+NAN_METHOD(GetProgressUpdates)
+{
+    try {
+        // Drain every pending update. This never blocks the simulator, which may still be running.
+        v8::Local<v8::Array> ret = Nan::New<v8::Array>();
+        lc3::SimProgress progress;
+        for(uint32_t i = 0; sim->getProgressUpdate(progress); i += 1) {
+            v8::Local<v8::Object> update = Nan::New<v8::Object>();
+            Nan::Set(update, Nan::New("inst_exec_count").ToLocalChecked(),
+                Nan::New<v8::Number>(static_cast<double>(progress.inst_exec_count)));
+            Nan::Set(update, Nan::New("pc").ToLocalChecked(), Nan::New<v8::Number>(progress.pc));
+            Nan::Set(update, Nan::New("output").ToLocalChecked(), Nan::New(progress.output).ToLocalChecked());
+            v8::Local<v8::Array> ranges = Nan::New<v8::Array>(progress.modified_ranges.size());
+            for(uint32_t j = 0; j < progress.modified_ranges.size(); j += 1) {
+                std::pair<uint16_t, uint16_t> const & modified = progress.modified_ranges[j];
+                v8::Local<v8::Object> range = Nan::New<v8::Object>();
+                Nan::Set(range, Nan::New("start").ToLocalChecked(), Nan::New<v8::Number>(modified.first));
+                Nan::Set(range, Nan::New("end").ToLocalChecked(), Nan::New<v8::Number>(modified.second));
+                Nan::Set(ranges, j, range);
+            }
+            Nan::Set(update, Nan::New("modified_ranges").ToLocalChecked(), ranges);
+            Nan::Set(update, Nan::New("finished").ToLocalChecked(), Nan::New<v8::Boolean>(progress.finished));
+            Nan::Set(ret, i, update);
+        }
+        info.GetReturnValue().Set(ret);
+    } catch(std::exception const & e) {
+        Nan::ThrowError(e.what());
+    }
+}
+
+NAN_METHOD(SetEnableFramebuffer)
+{
+    if(info.Length() != 1) {
+        Nan::ThrowError("Requires 1 argument");
+        return;
+    }
+
+    if(! info[0]->IsBoolean()) {
+        Nan::ThrowError("Must provide setting as a bool argument");
+        return;
+    }
+
+    try {
+        sim->setEnableFramebuffer(Nan::To<bool>(info[0]).FromJust());
+    } catch(std::exception const & e) {
+        Nan::ThrowError(e.what());
+    }
+}
+
+NAN_METHOD(GetFramebuffer)
+{
+    try {
+        uint32_t count = lc3::core::Framebuffer::SIZE;
+        v8::Local<v8::ArrayBuffer> buffer = v8::ArrayBuffer::New(v8::Isolate::GetCurrent(), count * sizeof(uint16_t));
+        v8::Local<v8::Uint16Array> ret = v8::Uint16Array::New(buffer, 0, count);
+        Nan::TypedArrayContents<uint16_t> values(ret);
+        sim->readMemRange(lc3::core::Framebuffer::START, count, *values);
+        info.GetReturnValue().Set(ret);
+    } catch(std::exception const & e) {
+        Nan::ThrowError(e.what());
+    }
+}
+
+NAN_METHOD(GetAndClearFramebufferDirtyRects)
+{
+    try {
+        std::vector<lc3::core::FramebufferRect> rects = sim->getAndClearFramebufferDirtyRects();
+        v8::Local<v8::Array> ret = Nan::New<v8::Array>(rects.size());
+        for(uint32_t i = 0; i < rects.size(); i += 1) {
+            v8::Local<v8::Object> rect = Nan::New<v8::Object>();
+            Nan::Set(rect, Nan::New("x").ToLocalChecked(), Nan::New<v8::Number>(rects[i].x));
+            Nan::Set(rect, Nan::New("y").ToLocalChecked(), Nan::New<v8::Number>(rects[i].y));
+            Nan::Set(rect, Nan::New("width").ToLocalChecked(), Nan::New<v8::Number>(rects[i].width));
+            Nan::Set(rect, Nan::New("height").ToLocalChecked(), Nan::New<v8::Number>(rects[i].height));
+            Nan::Set(ret, i, rect);
+        }
+        info.GetReturnValue().Set(ret);
+    } catch(std::exception const & e) {
+        Nan::ThrowError(e.what());
+    }
+}
+
 NAN_METHOD(SetMemLine)
 {
     if(info.Length() != 2) {
@@ -559,6 +765,36 @@ NAN_METHOD(ClearOutput)
     }
 }
 
+NAN_METHOD(SetOutputLimit)
+{
+    if(info.Length() != 2) {
+        Nan::ThrowError("Requires 2 arguments");
+        return;
+    }
+
+    if(! info[0]->IsNumber() || ! info[1]->IsBoolean()) {
+        Nan::ThrowError("Must provide limit as a numerical argument and whether to stop as a bool argument");
+        return;
+    }
+
+    try {
+        uint32_t limit = Nan::To<uint32_t>(info[0]).FromJust();
+        sim->setOutputLimit(limit, Nan::To<bool>(info[1]).FromJust());
+    } catch(std::exception const & e) {
+        Nan::ThrowError(e.what());
+    }
+}
+
+NAN_METHOD(DidExceedOutputLimit)
+{
+    try {
+        auto ret = Nan::New<v8::Boolean>(sim->didExceedOutputLimit());
+        info.GetReturnValue().Set(ret);
+    } catch(std::exception const & e) {
+        Nan::ThrowError(e.what());
+    }
+}
+
 NAN_METHOD(SetBreakpoint)
 {
     if(info.Length() != 1) {
@@ -639,10 +875,19 @@ NAN_MODULE_INIT(NanInit)
     NAN_EXPORT(target, Pause);
 
     NAN_EXPORT(target, GetRegValue);
+    NAN_EXPORT(target, GetRegisters);
     NAN_EXPORT(target, SetRegValue);
     NAN_EXPORT(target, GetMemValue);
+    NAN_EXPORT(target, GetMemRange);
     NAN_EXPORT(target, SetMemValue);
     NAN_EXPORT(target, GetMemLine);
+    NAN_EXPORT(target, GetMemLines);
+    NAN_EXPORT(target, GetAndClearModifiedRanges);
+    NAN_EXPORT(target, SetProgressUpdates);
+    NAN_EXPORT(target, GetProgressUpdates);
+    NAN_EXPORT(target, SetEnableFramebuffer);
+    NAN_EXPORT(target, GetFramebuffer);
+    NAN_EXPORT(target, GetAndClearFramebufferDirtyRects);
     NAN_EXPORT(target, SetMemLine);
     NAN_EXPORT(target, SetIgnorePrivilege);
 
@@ -650,6 +895,8 @@ NAN_MODULE_INIT(NanInit)
     NAN_EXPORT(target, AddInput);
     NAN_EXPORT(target, GetAndClearOutput);
     NAN_EXPORT(target, ClearOutput);
+    NAN_EXPORT(target, SetOutputLimit);
+    NAN_EXPORT(target, DidExceedOutputLimit);
 
     NAN_EXPORT(target, SetBreakpoint);
     NAN_EXPORT(target, RemoveBreakpoint);
@@ -700,18 +947,45 @@ void utils::UIPrinter::clearOutputBuffer(void)
 {
     std::lock_guard<std::mutex> const lock(output_buffer_mutex);
     output_buffer.clear();
+    limiter.reset();
 }
 
 void utils::UIPrinter::print(std::string const & string)
 {
     std::lock_guard<std::mutex> const lock(output_buffer_mutex);
-    output_buffer.push_back(string);
+    keep(string);
 }
 
 void utils::UIPrinter::newline(void)
 {
     std::lock_guard<std::mutex> const lock(output_buffer_mutex);
-    output_buffer.push_back("\n");
+    keep("\n");
+}
+
+void utils::UIPrinter::setOutputLimit(uint64_t limit)
+{
+    std::lock_guard<std::mutex> const lock(output_buffer_mutex);
+    limiter.setLimit(limit);
+}
+
+bool utils::UIPrinter::didExceedOutputLimit(void) const
+{
+    std::lock_guard<std::mutex> const lock(output_buffer_mutex);
+    return limiter.didExceed();
+}
+
+void utils::UIPrinter::keep(std::string const & string)
+{
+    bool add_marker;
+    uint64_t count = limiter.fit(string.size(), add_marker);
+    if(count == string.size()) {
+        output_buffer.push_back(string);
+    } else if(count != 0) {
+        output_buffer.push_back(string.substr(0, count));
+    }
+    if(add_marker) {
+        output_buffer.push_back(DEFAULT_OUTPUT_LIMIT_MARKER);
+    }
 }
 
 bool utils::UIInputter::getChar(char & c)
@@ -5,6 +5,7 @@
 #include <iostream>
 #include <functional>
 #include <map>
+#include <memory>
 #include <string>
 #include <sstream>
 #include <vector>
@@ -14,6 +15,7 @@
 namespace framework2
 {
 class Tester;
+class OutputExpectation;
 
 using test_func_t = std::function<void(lc3::sim &, Tester &, double total_points)>;
 
@@ -39,13 +41,25 @@ private:
     bool print_output, ignore_privilege, verbose;
     uint32_t print_level;
     uint64_t seed;
-    std::vector<std::string> obj_filenames;
+    std::vector<lc3::core::ObjectMemorySink> objs;
     lc3::core::SymbolTable symbol_table;
+    std::string trace_dir;
+    std::string input_record_dir, input_replay_dir;
+    bool native_traps;
+    uint64_t native_trap_charge;
+    bool poll_skipping;
+    bool loop_detection;
+    uint64_t loop_check_interval;
+    uint64_t output_limit;
+    bool exceeded_output_limit;
 
     BufferedPrinter * printer;
     StringInputter * inputter;
     lc3::sim * simulator;
 
+    std::shared_ptr<OutputExpectation> expected_output;
+    bool stop_when_output_complete;
+
     double test_points_earned;
 
     std::pair<double, double> testAll(void);
@@ -54,7 +68,8 @@ private:
     std::pair<double, double> testSingle(TestCase const & test);
     void resetTestPoints(void);
 
-    double checkSimilarityHelper(std::vector<char> const & source, std::vector<char> const & target) const;
+    double checkSimilarityHelper(std::string const & source, std::string const & target, double min_similarity) const;
+    void observeOutput(std::string const & str);
 
     friend int main(int argc, char * argv[]);
 
@@ -66,7 +81,7 @@ public:
     };
 
     Tester(bool print_output, uint32_t print_level, bool ignore_privilege, bool verbose,
-        uint64_t seed, std::vector<std::string> const & obj_filenames);
+        uint64_t seed, std::vector<lc3::core::ObjectMemorySink> const & objs);
 
     void registerTest(std::string const & name, test_func_t test_func, double points, bool randomize);
     void verify(std::string const & label, bool pred, double points);
@@ -78,18 +93,86 @@ public:
     void setInputCharDelay(uint32_t inst_count) { inputter->setCharDelay(inst_count); }
 
     std::string getOutput(void) const;
-    void clearOutput(void) { printer->clear(); }
+    void clearOutput(void);
     bool checkMatch(std::string const & a, std::string const & b) const { return a == b; }
     bool checkContain(std::string const & str, std::string const & expected_part) const;
+    // Element i of the result is checkContain(str, expected_parts[i]), but str is only scanned once.
+    std::vector<bool> checkContainEach(std::string const & str, std::vector<std::string> const & expected_parts) const;
     double checkSimilarity(std::string const & source, std::string const & target) const;
+    // Same as checkSimilarity, but stops comparing once the similarity is certain to be below min_similarity, in which
+    // case the returned value is also below min_similarity.
+    double checkSimilarity(std::string const & source, std::string const & target, double min_similarity) const;
     std::string getPreprocessedString(std::string const & str, uint64_t type) const;
 
+    // Compares the output printed from now on against expected, after preprocessing both with type, as the output is
+    // printed. The simulator is stopped as soon as the output can no longer match and, if stop_when_complete is set,
+    // as soon as all of the expected output has been printed.
+    void setExpectedOutput(std::string const & expected, uint64_t type, bool stop_when_complete);
+    void clearExpectedOutput(void);
+    // True if the output printed since setExpectedOutput can no longer match no matter what is printed next.
+    bool didOutputDiverge(void) const;
+    // True if the output printed since setExpectedOutput matches the expected output.
+    bool didOutputMatch(void) const;
+
     lc3::core::SymbolTable const & getSymbolTable(void) const { return symbol_table; }
 
 private:
     void setSymbolTable(lc3::core::SymbolTable const & symbol_table) { this->symbol_table = symbol_table; }
+    void setTraceDirectory(std::string const & trace_dir) { this->trace_dir = trace_dir; }
+    void setInputRecordDirectory(std::string const & input_record_dir) { this->input_record_dir = input_record_dir; }
+    void setInputReplayDirectory(std::string const & input_replay_dir) { this->input_replay_dir = input_replay_dir; }
+    void setNativeTraps(bool native_traps, uint64_t native_trap_charge)
+    {
+        this->native_traps = native_traps;
+        this->native_trap_charge = native_trap_charge;
+    }
+    void setPollSkipping(bool poll_skipping) { this->poll_skipping = poll_skipping; }
+    void setLoopDetection(bool loop_detection, uint64_t loop_check_interval)
+    {
+        this->loop_detection = loop_detection;
+        this->loop_check_interval = loop_check_interval;
+    }
+    void setOutputLimit(uint64_t output_limit) { this->output_limit = output_limit; }
     friend int framework2::main(int argc, char * argv[]);
 };
 
+// Preprocesses a string that is received a character at a time, with the same result as
+// Tester::getPreprocessedString. A character is only appended to the output once nothing received later can remove
+// it, i.e. whitespace is held back until it is followed by something else.
+class StreamPreprocessor
+{
+public:
+    StreamPreprocessor(uint64_t type) : type(type), skip(0) {}
+
+    void push(char c, std::string & out);
+
+private:
+    uint64_t type;
+    // Whitespace at the end of what has been received so far.
+    std::string pending;
+    // Number of upcoming characters that are not checked for new lines.
+    std::size_t skip;
+
+    void flush(char c, std::string & out);
+};
+
+class OutputExpectation
+{
+public:
+    OutputExpectation(std::string const & expected, uint64_t type);
+
+    void push(std::string const & str);
+    bool diverged(void) const { return has_diverged; }
+    bool complete(void) const { return ! has_diverged && matched == expected.size(); }
+
+private:
+    // Already preprocessed.
+    std::string expected;
+    StreamPreprocessor preprocessor;
+    std::string received;
+    std::size_t matched;
+    bool has_diverged;
+};
+
     int main(int argc, char * argv[]);
 };
@@ -3,25 +3,126 @@
  */
 #include "framework_common.h"
 
+#include <algorithm>
+#include <limits>
+#include <queue>
+
 bool endsWith(std::string const & search, std::string const & suffix)
 {
     if(suffix.size() > search.size()) { return false; }
     return std::equal(suffix.rbegin(), suffix.rend(), search.rbegin());
 }
 
+MultiStringMatcher::MultiStringMatcher(std::vector<std::string> const & patterns) : nodes(1),
+    pattern_count(patterns.size())
+{
+    for(uint32_t id = 0; id < patterns.size(); id += 1) {
+        if(patterns[id].empty()) {
+            empty_pattern_ids.push_back(id);
+            continue;
+        }
+
+        uint32_t cur = 0;
+        for(char c : patterns[id]) {
+            auto search = nodes[cur].next.find(c);
+            if(search == nodes[cur].next.end()) {
+                nodes[cur].next[c] = nodes.size();
+                cur = nodes.size();
+                nodes.emplace_back();
+            } else {
+                cur = search->second;
+            }
+        }
+        nodes[cur].pattern_ids.push_back(id);
+    }
+
+    // Fail links point to the node for the longest proper suffix that is also in the trie. A node's suffix is always
+    // shallower, so building in breadth-first order means its links are ready when its children need them.
+    std::queue<uint32_t> pending;
+    for(auto const & child : nodes[0].next) {
+        pending.push(child.second);
+    }
+    while(! pending.empty()) {
+        uint32_t cur = pending.front();
+        pending.pop();
+        for(auto const & child : nodes[cur].next) {
+            uint32_t fail = nodes[cur].fail;
+            while(fail != 0 && nodes[fail].next.count(child.first) == 0) {
+                fail = nodes[fail].fail;
+            }
+            auto search = nodes[fail].next.find(child.first);
+            Node & node = nodes[child.second];
+            node.fail = search != nodes[fail].next.end() ? search->second : 0;
+            node.match_link = nodes[node.fail].pattern_ids.empty() ? nodes[node.fail].match_link : node.fail;
+            pending.push(child.second);
+        }
+    }
+}
+
+std::vector<bool> MultiStringMatcher::findAll(std::string const & str) const
+{
+    std::vector<bool> found(pattern_count, false);
+    std::size_t remaining = pattern_count - empty_pattern_ids.size();
+    if(! str.empty()) {
+        for(uint32_t id : empty_pattern_ids) {
+            found[id] = true;
+        }
+    }
+
+    // Once a node is reported, so is every node along its match links, so each node is reported at most once.
+    std::vector<bool> reported(nodes.size(), false);
+    uint32_t cur = 0;
+    for(std::size_t i = 0; i < str.size() && remaining > 0; i += 1) {
+        auto search = nodes[cur].next.find(str[i]);
+        while(cur != 0 && search == nodes[cur].next.end()) {
+            cur = nodes[cur].fail;
+            search = nodes[cur].next.find(str[i]);
+        }
+        cur = search != nodes[cur].next.end() ? search->second : 0;
+
+        uint32_t match = nodes[cur].pattern_ids.empty() ? nodes[cur].match_link : cur;
+        while(match != 0 && ! reported[match]) {
+            reported[match] = true;
+            for(uint32_t id : nodes[match].pattern_ids) {
+                found[id] = true;
+                remaining -= 1;
+            }
+            match = nodes[match].match_link;
+        }
+    }
+
+    return found;
+}
+
 void BufferedPrinter::print(std::string const & string)
 {
-    std::copy(string.begin(), string.end(), std::back_inserter(display_buffer));
-    if(print_output) {
-        std::cout << string;
+    keep(string);
+    if(observer) {
+        observer(string);
     }
 }
 
 void BufferedPrinter::newline(void)
 {
-    display_buffer.push_back('\n');
-    if(print_output) {
-        std::cout << "\n";
+    keep("\n");
+    if(observer) {
+        observer("\n");
+    }
+}
+
+void BufferedPrinter::keep(std::string const & string)
+{
+    bool add_marker;
+    std::string::size_type count = limiter.fit(string.size(), add_marker);
+    std::copy(string.begin(), string.begin() + count, std::back_inserter(display_buffer));
+    if(add_marker) {
+        std::string marker = DEFAULT_OUTPUT_LIMIT_MARKER;
+        std::copy(marker.begin(), marker.end(), std::back_inserter(display_buffer));
+    }
+
+    // Only print what is kept, so that the printed output is the same as the output that is checked.
+    if(print_output && (count != 0 || add_marker)) {
+        std::cout << string.substr(0, count) << (add_marker ? DEFAULT_OUTPUT_LIMIT_MARKER : "");
     }
 }
 
@@ -43,6 +144,20 @@ void StringInputter::setStringAfter(std::string const & source, uint32_t inst_co
     setCharDelay(inst_count);
 }
 
+uint64_t StringInputter::getIdleCount(void) const
+{
+    if(pos == source.size()) {
+        return std::numeric_limits<uint64_t>::max();
+    }
+
+    return cur_inst_delay;
+}
+
+void StringInputter::skipIdle(uint64_t count)
+{
+    cur_inst_delay -= static_cast<uint32_t>(std::min<uint64_t>(count, cur_inst_delay));
+}
+
 bool StringInputter::getChar(char & c)
 {
     if(cur_inst_delay > 0) {
@@ -2,7 +2,10 @@
  * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
  */
 #include <cstdint>
+#include <functional>
+#include <map>
 #include <string>
+#include <vector>
 
 #include "inputter.h"
 #include "interface.h"
@@ -16,12 +19,24 @@ public:
     virtual void setColor(lc3::utils::PrintColor color) override { (void) color; }
     virtual void print(std::string const & string) override;
     virtual void newline(void) override;
-    void clear(void) { display_buffer.clear(); }
+    virtual void setOutputLimit(uint64_t limit) override { limiter.setLimit(limit); }
+    virtual bool didExceedOutputLimit(void) const override { return limiter.didExceed(); }
+    void clear(void)
+    {
+        display_buffer.clear();
+        limiter.reset();
+    }
     std::vector<char> const & getBuffer(void) const { return display_buffer; }
+    // Called with everything that is printed, as it is printed.
+    void setOutputObserver(std::function<void(std::string const &)> observer) { this->observer = observer; }
 
 private:
     bool print_output;
     std::vector<char> display_buffer;
+    lc3::utils::OutputLimiter limiter;
+    std::function<void(std::string const &)> observer;
+
+    void keep(std::string const & string);
 };
 
 class StringInputter : public lc3::utils::IInputter
@@ -37,6 +52,8 @@ public:
     virtual bool getChar(char & c) override;
     virtual void endInput(void) override {}
     virtual bool hasRemaining(void) const override { return pos == source.size(); }
+    virtual uint64_t getIdleCount(void) const override;
+    virtual void skipIdle(uint64_t count) override;
 
 private:
     std::string source;
@@ -44,4 +61,32 @@ private:
     uint32_t reset_inst_delay, cur_inst_delay;
 };
 
+// Finds which of a set of patterns occur in a string with a single pass over the string (Aho-Corasick), so checking
+// for many expected fragments takes about as long as checking for one.
+class MultiStringMatcher
+{
+public:
+    MultiStringMatcher(std::vector<std::string> const & patterns);
+
+    // Element i of the result is true if pattern i is a substring of str. As with Tester::checkContain, an empty
+    // pattern is only found in a non-empty string.
+    std::vector<bool> findAll(std::string const & str) const;
+
+private:
+    struct Node
+    {
+        std::map<char, uint32_t> next;
+        uint32_t fail;
+        // Nearest node along the fail links that completes a pattern, or 0 if there is none.
+        uint32_t match_link;
+        std::vector<uint32_t> pattern_ids;
+
+        Node(void) : fail(0), match_link(0) {}
+    };
+
+    std::vector<Node> nodes;
+    std::vector<uint32_t> empty_pattern_ids;
+    std::size_t pattern_count;
+};
+
 bool endsWith(std::string const & search, std::string const & suffix);
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#define API_VER 2
+#include "framework.h"
+
+// Expects both solutions/macros.asm and solutions/macros_expanded.asm, which is the same program with its macros
+// expanded by hand, placed at x4000 instead of x3000.
+static uint16_t const MACRO_START = 0x3000;
+static uint16_t const EXPANDED_START = 0x4000;
+
+static bool findSymbol(Tester & tester, std::string const & name, uint32_t & addr)
+{
+    lc3::core::SymbolTable const & symbols = tester.getSymbolTable();
+    auto symbol = symbols.find(name);
+    if(symbol == symbols.end()) {
+        tester.error("Missing label", name);
+        return false;
+    }
+    addr = symbol->second;
+    return true;
+}
+
+void ExpansionTest(lc3::sim & sim, Tester & tester, double total_points)
+{
+    uint32_t macro_end, expanded_end;
+    if(! findSymbol(tester, "progend", macro_end) || ! findSymbol(tester, "exprogend", expanded_end)) { return; }
+
+    uint32_t size = macro_end - MACRO_START;
+    tester.verify("Same size", size == expanded_end - EXPANDED_START, total_points / 2);
+
+    uint32_t mismatches = 0;
+    for(uint32_t i = 0; i < size; i += 1) {
+        uint16_t actual = sim.readMem(static_cast<uint16_t>(MACRO_START + i));
+        uint16_t expected = sim.readMem(static_cast<uint16_t>(EXPANDED_START + i));
+        if(actual != expected) {
+            std::stringstream msg;
+            msg << "x" << std::hex << (MACRO_START + i) << " is x" << actual << " but should be x" << expected;
+            tester.output(msg.str());
+            mismatches += 1;
+        }
+    }
+    tester.verify("Same code", mismatches == 0, total_points / 2);
+}
+
+void RunTest(lc3::sim & sim, Tester & tester, double total_points)
+{
+    sim.writePC(MACRO_START);
+
+    bool success = sim.runUntilHalt();
+    if(! success) { tester.error("Error", "Execution hit exception"); return; }
+
+    tester.verify("Forwarded parameters", sim.readReg(1) == 8, total_points / 3);
+    tester.verify("Single parameter", sim.readReg(2) == 1, total_points / 3);
+    tester.verify("String in macro", tester.checkMatch(tester.getOutput(), "reg"), total_points / 3);
+}
+
+void testBringup(lc3::sim & sim)
+{
+    sim.setRunInstLimit(1000);
+}
+
+void testTeardown(lc3::sim & sim)
+{
+    (void) sim;
+}
+
+void setup(Tester & tester)
+{
+    tester.registerTest("Expansion", ExpansionTest, 50, false);
+    tester.registerTest("Run", RunTest, 50, false);
+}
+
+void shutdown(void) {}
@@ -0,0 +1,23 @@
+;
+; Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+;
+; macros_expanded.asm is the same program with the macros expanded by hand. It is placed at x4000 so that both can be
+; loaded at once and compared.
+.orig x3000
+.include "macros_lib.asm"
+
+         ld r6, Stack
+         and r1, r1, #0
+         and r2, r2, #0
+         add r3, r2, #2
+         ; add 4 to r1 twice, through a labeled invocation
+Loop     INC2 r1
+         INC2 r1
+         add r3, r3, #-1
+         brp Loop
+         INC r2
+         GREET r1
+         halt
+Stack    .fill xfe00
+ProgEnd  .fill x0000
+.end
@@ -0,0 +1,30 @@
+;
+; Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+;
+; macros.asm with its macros expanded by hand.
+.orig x4000
+
+           ld r6, ExStack
+           and r1, r1, #0
+           and r2, r2, #0
+           add r3, r2, #2
+ExLoop     add r1, r1, #1
+           add r1, r1, #1
+           add r1, r1, #1
+           add r1, r1, #1
+           add r3, r3, #-1
+           brp ExLoop
+           add r2, r2, #1
+           add r6, r6, #-1
+           str r1, r6, #0
+           lea r0, ExGreeting
+           puts
+           ldr r1, r6, #0
+           add r6, r6, #1
+           br ExGreetDone
+ExGreeting .stringz "reg"
+ExGreetDone
+           halt
+ExStack    .fill xfe00
+ExProgEnd  .fill x0000
+.end
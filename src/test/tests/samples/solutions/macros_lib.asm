@@ -0,0 +1,36 @@
+;
+; Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+;
+; Macros used by macros.asm, which includes this file by a path relative to itself.
+
+.macro PUSH reg
+    ADD R6, R6, #-1
+    STR reg, R6, #0
+.endm
+
+.macro POP reg
+    LDR reg, R6, #0
+    ADD R6, R6, #1
+.endm
+
+.macro INC reg
+    ADD reg, reg, #1
+.endm
+
+; Forwards its parameter to another macro.
+.macro INC2 reg
+    INC reg
+    INC reg
+.endm
+
+; Prints a string that is defined in the body, so it may only be used once. The string is the name of the parameter,
+; which must not be replaced.
+.macro GREET reg
+    PUSH reg
+    LEA R0, Greeting
+    PUTS
+    POP reg
+    BR GreetDone
+Greeting .STRINGZ "reg"
+GreetDone
+.endm